@@ -3,5 +3,7 @@
 #include "Explorer.h"
 
 
+DEFINE_LOG_CATEGORY(LogExplorer);
+
 IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, Explorer, "Explorer" );
  
\ No newline at end of file
@@ -0,0 +1,217 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerAllocations.h"
+#include "ExplorerStats.h"
+
+bool FExplorerAllocations::bTracking = false;
+int32 FExplorerAllocations::CurrentScope = INDEX_NONE;
+int32 FExplorerAllocations::NumAllocatingFrames = 0;
+
+namespace ExplorerAllocations
+{
+    static TAutoConsoleVariable<int32> CVarWarmUpFrames(
+        TEXT("Explorer.Alloc.WarmUpFrames"),
+        300,
+        TEXT("Frames after allocation tracking starts before every frame is expected to be allocation free."));
+
+    /** Frames reported in detail before the log only gets the count */
+    static const int32 MaxReportedFrames = 20;
+
+    static uint32 FrameCount[EExplorerCsvStat::Max] = { 0 };
+    static uint64 FrameBytes[EExplorerCsvStat::Max] = { 0 };
+    static uint64 TotalCount[EExplorerCsvStat::Max] = { 0 };
+    static uint64 TotalBytes[EExplorerCsvStat::Max] = { 0 };
+    static int32 FramesTracked = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerCountingMalloc
+#pragma mark FExplorerCountingMalloc
+
+/** Passes everything on to the original GMalloc, counting allocations made inside allocation scopes */
+class FExplorerCountingMalloc : public FMalloc
+{
+public:
+    explicit FExplorerCountingMalloc(FMalloc* InInner)
+        : Inner(InInner)
+    {
+    }
+
+    virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+    {
+        FExplorerAllocations::CountAllocation(Count);
+        return Inner->Malloc(Count, Alignment);
+    }
+
+    virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+    {
+        // Shrinking and freeing through Realloc are not allocations
+        if (Count > 0)
+        {
+            FExplorerAllocations::CountAllocation(Count);
+        }
+        return Inner->Realloc(Original, Count, Alignment);
+    }
+
+    virtual void Free(void* Original) override
+    {
+        Inner->Free(Original);
+    }
+
+    virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+    {
+        return Inner->GetAllocationSize(Original, SizeOut);
+    }
+
+    virtual bool IsInternallyThreadSafe() const override
+    {
+        return Inner->IsInternallyThreadSafe();
+    }
+
+    virtual bool ValidateHeap() override
+    {
+        return Inner->ValidateHeap();
+    }
+
+    virtual void DumpAllocatorStats(class FOutputDevice& Ar) override
+    {
+        Inner->DumpAllocatorStats(Ar);
+    }
+
+    virtual const TCHAR* GetDescriptiveName() override
+    {
+        return Inner->GetDescriptiveName();
+    }
+
+private:
+    FMalloc* Inner;
+};
+
+namespace ExplorerAllocations
+{
+    static void InstallCountingMalloc()
+    {
+        static bool bInstalled = false;
+        if (bInstalled) return;
+        bInstalled = true;
+
+        // Never removed: blocks allocated through it can be freed at any time, and it only forwards
+        GMalloc = new FExplorerCountingMalloc(GMalloc);
+    }
+
+    static FAutoConsoleCommand StartCommand(
+        TEXT("Explorer.Alloc.Start"),
+        TEXT("Starts counting heap allocations in the character's per-frame and input paths."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerAllocations::StartTracking));
+
+    static FAutoConsoleCommand StopCommand(
+        TEXT("Explorer.Alloc.Stop"),
+        TEXT("Stops counting heap allocations and logs the result."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerAllocations::StopTracking));
+
+    static FAutoConsoleCommand DumpCommand(
+        TEXT("Explorer.Alloc.Dump"),
+        TEXT("Writes the heap allocation counts to the log."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerAllocations::Dump));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerAllocations
+#pragma mark - FExplorerAllocations
+
+void FExplorerAllocations::StartTracking()
+{
+    using namespace ExplorerAllocations;
+
+    InstallCountingMalloc();
+
+    FMemory::Memzero(FrameCount, sizeof(FrameCount));
+    FMemory::Memzero(FrameBytes, sizeof(FrameBytes));
+    FMemory::Memzero(TotalCount, sizeof(TotalCount));
+    FMemory::Memzero(TotalBytes, sizeof(TotalBytes));
+    FramesTracked = 0;
+    NumAllocatingFrames = 0;
+    bTracking = true;
+
+    UE_LOG(LogExplorer, Log, TEXT("Tracking allocations, expecting none after %d frames"), CVarWarmUpFrames.GetValueOnGameThread());
+}
+
+void FExplorerAllocations::StopTracking()
+{
+    if (!bTracking) return;
+
+    bTracking = false;
+    Dump();
+}
+
+void FExplorerAllocations::CountAllocation(SIZE_T Size)
+{
+    using namespace ExplorerAllocations;
+
+    // CurrentScope is only ever set on the game thread, but it is read here from every thread
+    if (!bTracking || CurrentScope == INDEX_NONE || !IsInGameThread()) return;
+
+    FrameCount[CurrentScope]++;
+    FrameBytes[CurrentScope] += Size;
+}
+
+void FExplorerAllocations::EndFrame()
+{
+    using namespace ExplorerAllocations;
+
+    uint32 count = 0;
+    uint64 bytes = 0;
+    for (int32 Stat = 0; Stat < EExplorerCsvStat::Max; Stat++)
+    {
+        count += FrameCount[Stat];
+        bytes += FrameBytes[Stat];
+    }
+
+    SET_DWORD_STAT(STAT_ExplorerAllocations, count);
+    SET_DWORD_STAT(STAT_ExplorerAllocatedBytes, (uint32)bytes);
+
+    FramesTracked++;
+    if (count > 0 && FramesTracked > CVarWarmUpFrames.GetValueOnGameThread())
+    {
+        NumAllocatingFrames++;
+        if (NumAllocatingFrames <= MaxReportedFrames)
+        {
+            FString breakdown;
+            for (int32 Stat = 0; Stat < EExplorerCsvStat::Max; Stat++)
+            {
+                if (FrameCount[Stat] == 0) continue;
+                breakdown += FString::Printf(TEXT(" %s: %u (%llu bytes)"), FExplorerStats::GetCsvStatName((EExplorerCsvStat::Type)Stat), FrameCount[Stat], FrameBytes[Stat]);
+            }
+            UE_LOG(LogExplorer, Error, TEXT("Frame %llu allocated %u times, %llu bytes:%s"), (uint64)GFrameCounter, count, bytes, *breakdown);
+        }
+    }
+
+    for (int32 Stat = 0; Stat < EExplorerCsvStat::Max; Stat++)
+    {
+        TotalCount[Stat] += FrameCount[Stat];
+        TotalBytes[Stat] += FrameBytes[Stat];
+    }
+    FMemory::Memzero(FrameCount, sizeof(FrameCount));
+    FMemory::Memzero(FrameBytes, sizeof(FrameBytes));
+}
+
+void FExplorerAllocations::Dump()
+{
+    using namespace ExplorerAllocations;
+
+    UE_LOG(LogExplorer, Log, TEXT("Allocations over %d frames (%d warm up):"), FramesTracked, CVarWarmUpFrames.GetValueOnGameThread());
+    for (int32 Stat = 0; Stat < EExplorerCsvStat::Max; Stat++)
+    {
+        UE_LOG(LogExplorer, Log, TEXT("  %-20s %8llu allocations %10llu bytes"), FExplorerStats::GetCsvStatName((EExplorerCsvStat::Type)Stat), TotalCount[Stat], TotalBytes[Stat]);
+    }
+
+    if (NumAllocatingFrames > 0)
+    {
+        UE_LOG(LogExplorer, Error, TEXT("%d frames allocated after the warm up"), NumAllocatingFrames);
+    }
+    else
+    {
+        UE_LOG(LogExplorer, Log, TEXT("No frame allocated after the warm up"));
+    }
+}
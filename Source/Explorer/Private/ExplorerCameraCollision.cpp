@@ -0,0 +1,189 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerCameraCollision.h"
+#include "ExplorerCharacter.h"
+#include "ExplorerStats.h"
+#include "Engine.h"
+
+namespace ExplorerCameraCollision
+{
+    static const FName TraceTag(TEXT("ExplorerCameraCollision"));
+
+    /** Below this swing rate, in deg/sec, the predicted probe is skipped */
+    static const float MinPredictedYawRate = 5.f;
+
+    /** Bits of an entry's generation kept in a sweep's user data */
+    static const uint32 GenerationMask = 0xff;
+
+    /** Packs an entry's slot and generation and the probe into a sweep's user data */
+    static inline uint32 MakeUserData(int32 Slot, uint32 Generation, uint32 Probe) { return (((uint32)Slot << 8 | (Generation & GenerationMask)) << 1) | Probe; }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerCameraCollision
+#pragma mark FExplorerCameraCollision
+
+FExplorerCameraCollision& FExplorerCameraCollision::Get()
+{
+    static FExplorerCameraCollision Instance;
+    return Instance;
+}
+
+FExplorerCameraCollision::FExplorerCameraCollision()
+{
+    SweepDelegate.BindRaw(this, &FExplorerCameraCollision::OnSweepCompleted);
+}
+
+TStatId FExplorerCameraCollision::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(FExplorerCameraCollision, STATGROUP_Tickables);
+}
+
+void FExplorerCameraCollision::Register(AExplorerCharacter* Character)
+{
+    check(Character != NULL);
+    if (Character->CameraCollisionSlot != INDEX_NONE) return;
+
+    const int32 slot = (FreeSlots.Num() > 0) ? FreeSlots.Pop() : Entries.AddZeroed();
+    Character->CameraCollisionSlot = slot;
+
+    FEntry& entry = Entries[slot];
+    entry.Character = Character;
+    entry.bInUse = true;
+    entry.ArmLength = -1.f;
+    entry.PreviousYaw = 0.f;
+    entry.FreeLength[CurrentProbe] = MAX_FLT;
+    entry.FreeLength[PredictedProbe] = MAX_FLT;
+    entry.QueryParams = FCollisionQueryParams(ExplorerCameraCollision::TraceTag, false, Character);
+}
+
+void FExplorerCameraCollision::Unregister(AExplorerCharacter* Character)
+{
+    check(Character != NULL);
+    if (!Entries.IsValidIndex(Character->CameraCollisionSlot)) return;
+
+    FreeSlot(Character->CameraCollisionSlot);
+    Character->CameraCollisionSlot = INDEX_NONE;
+}
+
+float FExplorerCameraCollision::ClampArmLength(const AExplorerCharacter& Character, float ArmLength) const
+{
+    if (!Entries.IsValidIndex(Character.CameraCollisionSlot)) return ArmLength;
+
+    const FEntry& entry = Entries[Character.CameraCollisionSlot];
+    return (entry.ArmLength >= 0.f) ? FMath::Min(ArmLength, entry.ArmLength) : ArmLength;
+}
+
+void FExplorerCameraCollision::Tick(float DeltaTime)
+{
+    EXPLORER_SCOPE_CYCLE_COUNTER(CameraCollision);
+
+    for (int32 Index = 0; Index < Entries.Num(); Index++)
+    {
+        FEntry& entry = Entries[Index];
+        if (!entry.bInUse) continue;
+
+        if (!entry.Character.IsValid())
+        {
+            FreeSlot(Index);
+            continue;
+        }
+
+        UpdateEntry(entry, DeltaTime);
+    }
+}
+
+void FExplorerCameraCollision::FreeSlot(int32 Slot)
+{
+    FEntry& entry = Entries[Slot];
+    entry.Character.Reset();
+    entry.bInUse = false;
+    entry.Generation++;
+    FreeSlots.Add(Slot);
+}
+
+void FExplorerCameraCollision::UpdateEntry(FEntry& Entry, float DeltaTime)
+{
+    using namespace ExplorerCameraCollision;
+
+    AExplorerCharacter* character = Entry.Character.Get();
+    UWorld* world = character->GetWorld();
+
+    // Only a camera a local player looks through needs collision (AI controllers are local too), and first person has no arm
+    const bool bLocalPlayer = character->IsLocallyControlled() && Cast<APlayerController>(character->Controller) != NULL;
+    if (world == NULL || !bLocalPlayer || character->IsInFirstPersonMode())
+    {
+        Entry.ArmLength = -1.f;
+        Entry.FreeLength[CurrentProbe] = MAX_FLT;
+        Entry.FreeLength[PredictedProbe] = MAX_FLT;
+        return;
+    }
+
+    USpringArmComponent* boom = character->CameraBoom;
+    const UExplorerCameraProfile& profile = character->GetCameraProfile();
+    const float desiredLength = character->GetCameraArmLength();
+    const FRotator controlRotation = character->Controller->GetControlRotation();
+
+    // Apply the results of the sweeps issued last frame: pull in immediately, ease back out
+    const float freeLength = FMath::Min(desiredLength, FMath::Min(Entry.FreeLength[CurrentProbe], Entry.FreeLength[PredictedProbe]));
+    if (Entry.ArmLength < 0.f)
+    {
+        Entry.ArmLength = freeLength;
+        Entry.PreviousYaw = controlRotation.Yaw;
+    }
+    else if (freeLength < Entry.ArmLength)
+    {
+        Entry.ArmLength = freeLength;
+    }
+    else
+    {
+        Entry.ArmLength = FMath::FInterpTo(Entry.ArmLength, freeLength, DeltaTime, profile.CameraCollisionRecoverySpeed);
+    }
+    boom->TargetArmLength = Entry.ArmLength;
+
+    // Issue this frame's sweeps. They run with the rest of the frame's async traces and come back next frame.
+    const FVector origin = boom->GetComponentLocation() + boom->TargetOffset;
+    const FCollisionShape probeShape = FCollisionShape::MakeSphere(boom->ProbeSize);
+
+    world->AsyncSweep(origin, origin - controlRotation.Vector() * desiredLength, boom->ProbeChannel, probeShape, Entry.QueryParams,
+        FCollisionResponseParams::DefaultResponseParam, &SweepDelegate, MakeUserData(character->CameraCollisionSlot, Entry.Generation, CurrentProbe));
+
+    const float yawRate = (DeltaTime > 0.f) ? FRotator::NormalizeAxis(controlRotation.Yaw - Entry.PreviousYaw) / DeltaTime : 0.f;
+    Entry.PreviousYaw = controlRotation.Yaw;
+
+    if (FMath::Abs(yawRate) >= MinPredictedYawRate && profile.CameraCollisionLookAheadSeconds > 0.f)
+    {
+        FRotator predictedRotation = controlRotation;
+        predictedRotation.Yaw += yawRate * profile.CameraCollisionLookAheadSeconds;
+
+        world->AsyncSweep(origin, origin - predictedRotation.Vector() * desiredLength, boom->ProbeChannel, probeShape, Entry.QueryParams,
+            FCollisionResponseParams::DefaultResponseParam, &SweepDelegate, MakeUserData(character->CameraCollisionSlot, Entry.Generation, PredictedProbe));
+    }
+    else
+    {
+        Entry.FreeLength[PredictedProbe] = MAX_FLT;
+    }
+}
+
+void FExplorerCameraCollision::OnSweepCompleted(const FTraceHandle& Handle, FTraceDatum& Datum)
+{
+    using namespace ExplorerCameraCollision;
+
+    const uint32 probe = Datum.UserData & 1;
+    const uint32 generation = (Datum.UserData >> 1) & GenerationMask;
+    const int32 slot = (int32)(Datum.UserData >> 9);
+    if (!Entries.IsValidIndex(slot)) return;
+
+    FEntry& entry = Entries[slot];
+    if (!entry.bInUse || (entry.Generation & GenerationMask) != generation) return;
+
+    if (Datum.OutHits.Num() > 0 && Datum.OutHits[0].bBlockingHit)
+    {
+        entry.FreeLength[probe] = Datum.OutHits[0].Time * (Datum.End - Datum.Start).Size();
+    }
+    else
+    {
+        entry.FreeLength[probe] = MAX_FLT;
+    }
+}
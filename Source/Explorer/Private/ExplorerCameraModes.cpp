@@ -0,0 +1,283 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerCameraMode.h"
+#include "ExplorerCharacter.h"
+#include "ExplorerFollowCameraSolver.h"
+#include "ExplorerStats.h"
+#include "Engine.h"
+
+#if !UE_BUILD_SHIPPING
+static TAutoConsoleVariable<float> CVarMaxResetSeconds(
+    TEXT("Explorer.Check.MaxResetSeconds"),
+    30.f,
+    TEXT("A follow camera reset still running after this many simulated seconds is logged as an error."));
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerCameraModeRegistry
+#pragma mark FExplorerCameraModeRegistry
+
+FExplorerCameraModeRegistry& FExplorerCameraModeRegistry::Get()
+{
+    static FExplorerCameraModeRegistry Registry;
+    return Registry;
+}
+
+void FExplorerCameraModeRegistry::Register(uint8 ModeId, FExplorerCameraModeInfo::FFactory Factory, const TCHAR* DisplayName, bool bFirstPerson)
+{
+    check(Factory != NULL);
+    checkf(Modes[ModeId].Factory == NULL, TEXT("Camera mode %d (%s) is already registered as %s"), ModeId, DisplayName, Modes[ModeId].DisplayName);
+
+    Modes[ModeId].Factory = Factory;
+    Modes[ModeId].DisplayName = DisplayName;
+    Modes[ModeId].bFirstPerson = bFirstPerson;
+}
+
+uint8 FExplorerCameraModeRegistry::GetNextMode(uint8 ModeId) const
+{
+    for (int32 Offset = 1; Offset <= MaxModes; Offset++)
+    {
+        const uint8 Candidate = (uint8)((ModeId + Offset) % MaxModes);
+        if (Modes[Candidate].Factory != NULL) return Candidate;
+    }
+    return ModeId;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Third Person (Default UE4)
+#pragma mark - Third Person (Default UE4)
+
+/** Spring arm camera behind the character, driven directly by the controller */
+class FExplorerThirdPersonCameraMode : public FExplorerCameraMode
+{
+public:
+    FExplorerThirdPersonCameraMode()
+    {
+        Rig.bArmFollowsZoom = true;
+        Rig.bFirstPersonMeshes = false;
+        Rig.bUseControllerRotationYaw = false;
+    }
+
+    virtual void Enter(AExplorerCharacter& Character) override
+    {
+        Character.CancelCameraReset();
+    }
+};
+
+EXPLORER_REGISTER_CAMERA_MODE(FExplorerThirdPersonCameraMode, ECharacterCameraMode::ThirdPersonDefault, TEXT("Third Person (Default UE4)"), false);
+
+
+//////////////////////////////////////////////////////////////////////////
+// First Person
+#pragma mark - First Person
+
+/**
+ Camera at the character's head, character turns with the controller. The view pitches with the camera boom rather
+ than the character, so the character is still upright when it leaves first person.
+ */
+class FExplorerFirstPersonCameraMode : public FExplorerCameraMode
+{
+public:
+    FExplorerFirstPersonCameraMode()
+    {
+        Rig.bArmFollowsZoom = false;
+        Rig.ArmLength = 0.f;
+        Rig.bFirstPersonMeshes = true;
+        Rig.bUseControllerRotationYaw = true;
+    }
+
+    virtual void Enter(AExplorerCharacter& Character) override
+    {
+        Character.CancelCameraReset();
+    }
+};
+
+EXPLORER_REGISTER_CAMERA_MODE(FExplorerFirstPersonCameraMode, ECharacterCameraMode::FirstPerson, TEXT("First Person"), true);
+
+
+//////////////////////////////////////////////////////////////////////////
+// Third Person Follow
+#pragma mark - Third Person Follow
+
+/**
+ Arkham style smooth follow camera that turns with movement and resets to behind the character.
+
+ The follow and reset simulation runs at a fixed CameraSimulationStepSeconds, independent of the frame rate, with
+ leftover time carried over to the next frame. The view trails the simulation by up to one step and shows the latest
+ step interpolated by how far into it the current frame is.
+ */
+class FExplorerThirdPersonFollowCameraMode : public FExplorerThirdPersonCameraMode
+{
+public:
+    FExplorerThirdPersonFollowCameraMode()
+        : AccumulatedSeconds(0.f)
+        , PendingStepYaw(0.f)
+        , AppliedStepYaw(0.f)
+#if !UE_BUILD_SHIPPING
+        , ResetSeconds(0.f)
+#endif
+    {
+    }
+
+    virtual void Enter(AExplorerCharacter& Character) override
+    {
+        AccumulatedSeconds = 0.f;
+        PendingStepYaw = 0.f;
+        AppliedStepYaw = 0.f;
+
+        // Entering the follow camera while idle resets it straight away, as if the idle timer had just expired
+        if (Character.IsInputIdle())
+        {
+            Character.RequestCameraReset(true);
+        }
+    }
+
+    virtual bool HasPerFrameWork() const override { return true; }
+
+    virtual bool SupportsReset() const override { return true; }
+
+    virtual bool Update(AExplorerCharacter& Character, float DeltaSeconds) override
+    {
+        EXPLORER_SCOPE_CYCLE_COUNTER(FollowCamera);
+
+        const FExplorerMovementIntent& intent = Character.GetMovementIntent();
+
+        // Nothing to follow, nothing to reset, and the view has caught up with the simulation
+        if (Character.Controller == NULL || (!Character.IsCameraResetting() && !intent.HasMovement() && AppliedStepYaw == PendingStepYaw))
+        {
+            AccumulatedSeconds = 0.f;
+            return false;
+        }
+
+        const float stepSeconds = FMath::Max(Character.CameraSimulationStepSeconds, MinStepSeconds);
+
+        // Yaw input is scaled by the player controller before it reaches the control rotation
+        const APlayerController* playerController = Cast<APlayerController>(Character.Controller);
+        const float yawInputScale = (playerController != NULL) ? playerController->InputYawScale : 1.f;
+        const float controlYaw = Character.Controller->GetControlRotation().Yaw;
+
+        // After a hitch, drop the time that would take too many steps to catch up on
+        AccumulatedSeconds = FMath::Min(AccumulatedSeconds + DeltaSeconds, MaxStepsPerFrame * stepSeconds);
+
+        float yawInput = 0.f;
+        while (AccumulatedSeconds >= stepSeconds)
+        {
+            AccumulatedSeconds -= stepSeconds;
+
+            // The view catches up with the previous step, then the next one is simulated from where that left it
+            yawInput += PendingStepYaw - AppliedStepYaw;
+#if !UE_BUILD_SHIPPING
+            const bool bWasResetting = Character.IsCameraResetting();
+#endif
+            PendingStepYaw = Solve(Character, intent, controlYaw + yawInput * yawInputScale, stepSeconds);
+            AppliedStepYaw = 0.f;
+#if !UE_BUILD_SHIPPING
+            CheckResetStep(Character, bWasResetting, controlYaw + yawInput * yawInputScale, PendingStepYaw * yawInputScale, stepSeconds);
+#endif
+        }
+
+        // Show as much of the latest step as the time left over in the accumulator covers
+        const float interpolatedYaw = PendingStepYaw * (AccumulatedSeconds / stepSeconds);
+        yawInput += interpolatedYaw - AppliedStepYaw;
+        AppliedStepYaw = interpolatedYaw;
+
+        if (yawInput != 0.f)
+        {
+            Character.AddControllerYawInput(yawInput);
+        }
+
+        return Character.IsCameraResetting() || AppliedStepYaw != PendingStepYaw;
+    }
+
+private:
+    /** Most simulation steps run in one frame */
+    static const int32 MaxStepsPerFrame = 8;
+
+    /** Smallest simulation step allowed, whatever the character asks for */
+    static const float MinStepSeconds;
+
+    /**
+     * Advances the follow camera by one simulation step.
+     * @param ControlYaw    The control yaw as of the start of the step
+     * @return The yaw input for the step
+     */
+    static float Solve(AExplorerCharacter& Character, const FExplorerMovementIntent& Intent, float ControlYaw, float StepSeconds)
+    {
+        const FExplorerFollowCameraParams params = Character.GetCameraProfile().GetFollowParams();
+
+        const float meshYaw = Character.Mesh->GetTransformMatrix().Rotator().Yaw;
+        const float forwardAxis = Intent.ForwardAxis;
+        const float rightAxis = Intent.RightAxis;
+        const bool bWasResetting = Character.IsCameraResetting();
+        unsigned int flags = (bWasResetting ? EExplorerFollowCameraFlags::Resetting : 0) | (Character.IsCameraAutoResetting() ? EExplorerFollowCameraFlags::AutoReset : 0);
+        float yawInput = 0.f;
+
+        FExplorerFollowCameraBatch batch;
+        batch.Num = 1;
+        batch.ControlYaw = &ControlYaw;
+        batch.MeshYaw = &meshYaw;
+        batch.ForwardAxis = &forwardAxis;
+        batch.RightAxis = &rightAxis;
+        batch.Flags = &flags;
+        batch.YawInput = &yawInput;
+        SolveFollowCameras(params, StepSeconds, batch);
+
+        if (bWasResetting && !(flags & EExplorerFollowCameraFlags::Resetting))
+        {
+            EXPLORER_TRACE_EVENT(&Character, ResetFinished, Character.CameraModeEnum, Character.IsCameraAutoResetting() ? 1.f : 0.f);
+            Character.CancelCameraReset();
+        }
+
+        return yawInput;
+    }
+
+#if !UE_BUILD_SHIPPING
+    /**
+     * Logs an error when a reset step turns away from the reset target (the "long way around", or an overshoot),
+     * or when a reset runs for longer than Explorer.Check.MaxResetSeconds. Headless replay runs fail on these.
+     */
+    void CheckResetStep(const AExplorerCharacter& Character, bool bWasResetting, float ControlYaw, float StepYawDegrees, float StepSeconds)
+    {
+        if (!bWasResetting)
+        {
+            ResetSeconds = 0.f;
+            return;
+        }
+
+        const float targetYaw = Character.Mesh->GetTransformMatrix().Rotator().Yaw + FExplorerFollowCameraParams().MeshYawOffset;
+        const float distanceBefore = FMath::Abs(FRotator::NormalizeAxis(targetYaw - ControlYaw));
+        const float distanceAfter = FMath::Abs(FRotator::NormalizeAxis(targetYaw - ControlYaw - StepYawDegrees));
+        if (distanceAfter > distanceBefore + KINDA_SMALL_NUMBER)
+        {
+            UE_LOG(LogExplorer, Error, TEXT("%s: camera reset step moved away from its target (%.2f -> %.2f degrees)"), *Character.GetName(), distanceBefore, distanceAfter);
+            FExplorerStats::NoteFailedCheck();
+        }
+
+        const float maxResetSeconds = CVarMaxResetSeconds.GetValueOnGameThread();
+        if (ResetSeconds < maxResetSeconds && ResetSeconds + StepSeconds >= maxResetSeconds)
+        {
+            UE_LOG(LogExplorer, Error, TEXT("%s: camera reset has not converged after %.1f seconds (%.2f degrees to go)"), *Character.GetName(), maxResetSeconds, distanceAfter);
+            FExplorerStats::NoteFailedCheck();
+        }
+        ResetSeconds += StepSeconds;
+    }
+
+    /** Simulated time the current reset has been running */
+    float ResetSeconds;
+#endif
+
+    /** Simulation time not yet stepped */
+    float AccumulatedSeconds;
+
+    /** Yaw input produced by the latest simulation step */
+    float PendingStepYaw;
+
+    /** How much of PendingStepYaw has been passed on to the controller so far */
+    float AppliedStepYaw;
+};
+
+const float FExplorerThirdPersonFollowCameraMode::MinStepSeconds = 1.f / 240.f;
+
+EXPLORER_REGISTER_CAMERA_MODE(FExplorerThirdPersonFollowCameraMode, ECharacterCameraMode::ThirdPersonFollow, TEXT("Third Person Follow"), false);
@@ -0,0 +1,79 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerCameraProfile.h"
+
+//////////////////////////////////////////////////////////////////////////
+// UExplorerCameraProfile
+#pragma mark UExplorerCameraProfile
+
+UExplorerCameraProfile::UExplorerCameraProfile(const class FPostConstructInitializeProperties& PCIP)
+    : Super(PCIP)
+{
+    CameraFollowTurnAngleExponent = .5f;
+    CameraFollowTurnRate = .6f;
+    CameraResetSpeed = 2.f;
+
+    CameraZoomMinimumDistance = 100.f;
+    CameraZoomMaximumDistance = 600.f;
+    CameraZoomIncrement = 20.f;
+
+    AutoResetSmoothFollowCameraWhenIdle = true;
+    AutoResetDelaySeconds = 5.f;
+    AutoResetSpeed = .15f;
+
+    CameraCollisionRecoverySpeed = 5.f;
+    CameraCollisionLookAheadSeconds = .2f;
+
+    CameraModeBlendSeconds = .25f;
+
+    StreamingPrefetchSeconds = .5f;
+
+    FMemory::Memzero(TurnResponseTable, sizeof(TurnResponseTable));
+}
+
+void UExplorerCameraProfile::PostInitProperties()
+{
+    Super::PostInitProperties();
+    Bake();
+}
+
+void UExplorerCameraProfile::PostLoad()
+{
+    Super::PostLoad();
+    Bake();
+}
+
+void UExplorerCameraProfile::PostReloadConfig(UProperty* PropertyThatWasLoaded)
+{
+    Super::PostReloadConfig(PropertyThatWasLoaded);
+    Bake();
+}
+
+#if WITH_EDITOR
+void UExplorerCameraProfile::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+    Super::PostEditChangeProperty(PropertyChangedEvent);
+    Bake();
+}
+#endif
+
+void UExplorerCameraProfile::Bake()
+{
+    for (int32 Index = 0; Index <= TurnResponseTableSize; Index++)
+    {
+        TurnResponseTable[Index] = FMath::Pow((float)Index / TurnResponseTableSize, CameraFollowTurnAngleExponent);
+    }
+}
+
+FExplorerFollowCameraParams UExplorerCameraProfile::GetFollowParams() const
+{
+    FExplorerFollowCameraParams params;
+    params.TurnAngleExponent = CameraFollowTurnAngleExponent;
+    params.TurnRate = CameraFollowTurnRate;
+    params.ResetSpeed = CameraResetSpeed;
+    params.AutoResetSpeed = AutoResetSpeed;
+    params.TurnResponseTable = TurnResponseTable;
+    params.TurnResponseTableSize = TurnResponseTableSize;
+    return params;
+}
@@ -0,0 +1,139 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerCameraReplication.h"
+#include "ExplorerCharacter.h"
+#include "Engine.h"
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerReplicatedCameraState
+#pragma mark FExplorerReplicatedCameraState
+
+bool FExplorerReplicatedCameraState::NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess)
+{
+    uint32 Zoom = QuantizedZoom;
+    uint32 PackedFlags = Flags;
+
+    Ar.SerializeBits(&CameraMode, 8);
+    Ar.SerializeBits(&Zoom, ZoomBits);
+    Ar.SerializeBits(&PackedFlags, FlagBits);
+
+    if (Ar.IsLoading())
+    {
+        QuantizedZoom = (uint16)(Zoom & MaxQuantizedZoom);
+        Flags = (uint8)(PackedFlags & ((1 << FlagBits) - 1));
+    }
+    else if (OwnerCharacter != NULL && Map != NULL)
+    {
+        // The package map belongs to the connection being written to
+        FExplorerNetStats::RecordSent(Cast<UNetConnection>(Map->GetOuter()), OwnerCharacter, NumBits);
+    }
+
+    bOutSuccess = true;
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerNetStats
+#pragma mark - FExplorerNetStats
+
+namespace ExplorerNetStats
+{
+    struct FCounters
+    {
+        int64 BitsSent;
+        int64 BitsReceived;
+        int32 MessagesSent;
+        int32 MessagesReceived;
+
+        FCounters()
+            : BitsSent(0)
+            , BitsReceived(0)
+            , MessagesSent(0)
+            , MessagesReceived(0)
+        {
+        }
+    };
+
+    struct FConnectionCounters
+    {
+        FString Description;
+        double StartTime;
+        TMap<FName, FCounters> Characters;
+    };
+
+    static TMap<TWeakObjectPtr<UNetConnection>, FConnectionCounters> Connections;
+
+    static FCounters* FindCounters(const UNetConnection* Connection, const AActor* Character)
+    {
+        if (Connection == NULL || Character == NULL) return NULL;
+
+        TWeakObjectPtr<UNetConnection> Key(const_cast<UNetConnection*>(Connection));
+        FConnectionCounters* ConnectionCounters = Connections.Find(Key);
+        if (ConnectionCounters == NULL)
+        {
+            ConnectionCounters = &Connections.Add(Key, FConnectionCounters());
+            ConnectionCounters->Description = const_cast<UNetConnection*>(Connection)->LowLevelDescribe();
+            ConnectionCounters->StartTime = FPlatformTime::Seconds();
+        }
+
+        return &ConnectionCounters->Characters.FindOrAdd(Character->GetFName());
+    }
+
+    static FAutoConsoleCommand DumpCommand(
+        TEXT("Explorer.NetStats"),
+        TEXT("Writes per-connection, per-character camera replication bandwidth to the log."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerNetStats::Dump));
+
+    static FAutoConsoleCommand ResetCommand(
+        TEXT("Explorer.NetStats.Reset"),
+        TEXT("Clears the camera replication bandwidth counters."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerNetStats::Reset));
+}
+
+void FExplorerNetStats::RecordSent(const UNetConnection* Connection, const AActor* Character, int32 NumBits)
+{
+    ExplorerNetStats::FCounters* Counters = ExplorerNetStats::FindCounters(Connection, Character);
+    if (Counters == NULL) return;
+
+    Counters->BitsSent += NumBits;
+    Counters->MessagesSent++;
+}
+
+void FExplorerNetStats::RecordReceived(const UNetConnection* Connection, const AActor* Character, int32 NumBits)
+{
+    ExplorerNetStats::FCounters* Counters = ExplorerNetStats::FindCounters(Connection, Character);
+    if (Counters == NULL) return;
+
+    Counters->BitsReceived += NumBits;
+    Counters->MessagesReceived++;
+}
+
+void FExplorerNetStats::Dump()
+{
+    using namespace ExplorerNetStats;
+
+    const double Now = FPlatformTime::Seconds();
+    UE_LOG(LogExplorer, Log, TEXT("Camera replication bandwidth (payload only, excluding property and RPC headers):"));
+
+    for (auto ConnectionIt = Connections.CreateConstIterator(); ConnectionIt; ++ConnectionIt)
+    {
+        const FConnectionCounters& ConnectionCounters = ConnectionIt.Value();
+        const double Seconds = FMath::Max(Now - ConnectionCounters.StartTime, 1.0);
+        UE_LOG(LogExplorer, Log, TEXT("  %s%s (%.0fs)"), *ConnectionCounters.Description, ConnectionIt.Key().IsValid() ? TEXT("") : TEXT(" [closed]"), Seconds);
+
+        for (auto CharacterIt = ConnectionCounters.Characters.CreateConstIterator(); CharacterIt; ++CharacterIt)
+        {
+            const FCounters& Counters = CharacterIt.Value();
+            UE_LOG(LogExplorer, Log, TEXT("    %-32s sent %6d msgs %8.1f bytes (%6.2f B/s)   received %6d msgs %8.1f bytes (%6.2f B/s)"),
+                *CharacterIt.Key().ToString(),
+                Counters.MessagesSent, Counters.BitsSent / 8.0, Counters.BitsSent / 8.0 / Seconds,
+                Counters.MessagesReceived, Counters.BitsReceived / 8.0, Counters.BitsReceived / 8.0 / Seconds);
+        }
+    }
+}
+
+void FExplorerNetStats::Reset()
+{
+    ExplorerNetStats::Connections.Empty();
+}
@@ -0,0 +1,297 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerCameraTelemetry.h"
+#include "ExplorerCharacter.h"
+
+namespace ExplorerCameraTelemetry
+{
+    static TAutoConsoleVariable<int32> CVarEnable(
+        TEXT("Explorer.Telemetry.Enable"),
+        0,
+        TEXT("Record camera smoothness telemetry for locally viewed characters."));
+
+    static TAutoConsoleVariable<float> CVarAngularAccelerationThreshold(
+        TEXT("Explorer.Telemetry.AngularAccelerationThreshold"),
+        3000.f,
+        TEXT("Camera angular acceleration, in degrees per second squared, above which a frame is flagged."));
+
+    static TAutoConsoleVariable<float> CVarAngularJerkThreshold(
+        TEXT("Explorer.Telemetry.AngularJerkThreshold"),
+        100000.f,
+        TEXT("Camera angular jerk, in degrees per second cubed, above which a frame is flagged."));
+
+    static TAutoConsoleVariable<float> CVarLinearJerkThreshold(
+        TEXT("Explorer.Telemetry.LinearJerkThreshold"),
+        200000.f,
+        TEXT("Camera position jerk, in units per second cubed, above which a frame is flagged."));
+
+    static TAutoConsoleVariable<float> CVarModeSwitchErrorThreshold(
+        TEXT("Explorer.Telemetry.ModeSwitchErrorThreshold"),
+        1.f,
+        TEXT("Orientation error, in degrees, above which a camera mode switch is logged as a warning."));
+
+    /** Everything recorded in one camera mode */
+    struct FModeSummary
+    {
+        uint32 Frames;
+        uint32 FlaggedFrames;
+        double Seconds;
+        double SumAngularSpeed;
+        float MaxAngularSpeed;
+        float MaxAngularAcceleration;
+        double SumSquaredAngularJerk;
+        float MaxAngularJerk;
+        double SumSquaredLinearJerk;
+        float MaxLinearJerk;
+
+        /** Frames that jerk has been measured for */
+        uint32 JerkFrames;
+
+        FModeSummary() { FMemory::Memzero(this, sizeof(*this)); }
+    };
+
+    struct FModeSwitchSummary
+    {
+        uint32 Count;
+        uint32 Flagged;
+        double SumError;
+        float MaxError;
+
+        FModeSwitchSummary() { FMemory::Memzero(this, sizeof(*this)); }
+    };
+
+    static TMap<uint8, FModeSummary> ModeSummaries;
+    static FModeSwitchSummary ModeSwitchSummary;
+
+    static FString ExitExportFilename;
+
+    static void ExportOnExit()
+    {
+        FExplorerCameraTelemetry::Export(ExitExportFilename);
+    }
+
+    /** Applies the command line the first time telemetry is queried */
+    static void CheckCommandLine()
+    {
+        static bool bChecked = false;
+        if (bChecked) return;
+        bChecked = true;
+
+        if (FParse::Value(FCommandLine::Get(), TEXT("ExplorerTelemetry="), ExitExportFilename))
+        {
+            FCoreDelegates::OnPreExit.AddStatic(&ExportOnExit);
+            CVarEnable.AsVariable()->Set(TEXT("1"));
+        }
+        else if (FParse::Param(FCommandLine::Get(), TEXT("ExplorerTelemetry")))
+        {
+            CVarEnable.AsVariable()->Set(TEXT("1"));
+        }
+    }
+
+    static float GetRms(double SumSquares, uint32 Count)
+    {
+        return (Count > 0) ? (float)FMath::Sqrt(SumSquares / Count) : 0.f;
+    }
+
+    static void ExportCommand(const TArray<FString>& Args)
+    {
+        FExplorerCameraTelemetry::Export((Args.Num() > 0) ? Args[0] : FString());
+    }
+
+    static FAutoConsoleCommand DumpCommand(
+        TEXT("Explorer.Telemetry.Dump"),
+        TEXT("Writes the camera smoothness summary to the log."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerCameraTelemetry::Dump));
+
+    static FAutoConsoleCommand ExportConsoleCommand(
+        TEXT("Explorer.Telemetry.Export"),
+        TEXT("Writes the camera smoothness summary to a CSV file. Optional argument: file name."),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&ExportCommand));
+
+    static FAutoConsoleCommand ResetCommand(
+        TEXT("Explorer.Telemetry.Reset"),
+        TEXT("Clears the camera smoothness summary."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerCameraTelemetry::Reset));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerCameraTelemetry
+#pragma mark FExplorerCameraTelemetry
+
+FExplorerCameraTelemetry::FExplorerCameraTelemetry()
+    : NumSamples(0)
+    , Location(FVector::ZeroVector)
+    , Velocity(FVector::ZeroVector)
+    , Acceleration(FVector::ZeroVector)
+    , Rotation(FQuat::Identity)
+    , AngularVelocity(FVector::ZeroVector)
+    , AngularAcceleration(FVector::ZeroVector)
+{
+}
+
+bool FExplorerCameraTelemetry::IsEnabled()
+{
+    ExplorerCameraTelemetry::CheckCommandLine();
+    return ExplorerCameraTelemetry::CVarEnable.GetValueOnGameThread() != 0;
+}
+
+void FExplorerCameraTelemetry::AddFrame(uint8 CameraMode, const FVector& NewLocation, const FRotator& NewRotation, float DeltaSeconds)
+{
+    using namespace ExplorerCameraTelemetry;
+
+    const FQuat newRotation(NewRotation);
+    if (NumSamples == 0 || DeltaSeconds <= SMALL_NUMBER)
+    {
+        Location = NewLocation;
+        Rotation = newRotation;
+        NumSamples = 1;
+        return;
+    }
+
+    const float inverseDelta = 1.f / DeltaSeconds;
+
+    // Linear derivatives
+    const FVector newVelocity = (NewLocation - Location) * inverseDelta;
+    const FVector newAcceleration = (newVelocity - Velocity) * inverseDelta;
+    const FVector linearJerk = (newAcceleration - Acceleration) * inverseDelta;
+
+    // Angular derivatives, from the rotation between the two frames as an axis and angle
+    FQuat delta = newRotation * Rotation.Inverse();
+    if (delta.W < 0.f) delta = delta * -1.f;
+    FVector axis;
+    float angle;
+    delta.ToAxisAndAngle(axis, angle);
+    const FVector newAngularVelocity = axis * FMath::RadiansToDegrees(angle) * inverseDelta;
+    const FVector newAngularAcceleration = (newAngularVelocity - AngularVelocity) * inverseDelta;
+    const FVector angularJerk = (newAngularAcceleration - AngularAcceleration) * inverseDelta;
+
+    const bool bHasAcceleration = NumSamples >= 2;
+    const bool bHasJerk = NumSamples >= 3;
+
+    FModeSummary& summary = ModeSummaries.FindOrAdd(CameraMode);
+    summary.Frames++;
+    summary.Seconds += DeltaSeconds;
+
+    const float angularSpeed = newAngularVelocity.Size();
+    summary.SumAngularSpeed += angularSpeed;
+    summary.MaxAngularSpeed = FMath::Max(summary.MaxAngularSpeed, angularSpeed);
+
+    bool bFlagged = false;
+    if (bHasAcceleration)
+    {
+        const float angularAcceleration = newAngularAcceleration.Size();
+        summary.MaxAngularAcceleration = FMath::Max(summary.MaxAngularAcceleration, angularAcceleration);
+        bFlagged |= angularAcceleration > CVarAngularAccelerationThreshold.GetValueOnGameThread();
+    }
+    if (bHasJerk)
+    {
+        const float angularJerkSize = angularJerk.Size();
+        const float linearJerkSize = linearJerk.Size();
+        summary.JerkFrames++;
+        summary.SumSquaredAngularJerk += FMath::Square(angularJerkSize);
+        summary.MaxAngularJerk = FMath::Max(summary.MaxAngularJerk, angularJerkSize);
+        summary.SumSquaredLinearJerk += FMath::Square(linearJerkSize);
+        summary.MaxLinearJerk = FMath::Max(summary.MaxLinearJerk, linearJerkSize);
+        bFlagged |= angularJerkSize > CVarAngularJerkThreshold.GetValueOnGameThread();
+        bFlagged |= linearJerkSize > CVarLinearJerkThreshold.GetValueOnGameThread();
+    }
+
+    if (bFlagged)
+    {
+        summary.FlaggedFrames++;
+        UE_LOG(LogExplorer, Verbose, TEXT("Camera frame %llu flagged in %s: angular speed %.1f, acceleration %.1f, jerk %.1f, linear jerk %.1f"),
+            (uint64)GFrameCounter, GetNameForCameraMode((ECharacterCameraMode::Type)CameraMode),
+            angularSpeed, newAngularAcceleration.Size(), angularJerk.Size(), linearJerk.Size());
+    }
+
+    Location = NewLocation;
+    Velocity = newVelocity;
+    Acceleration = newAcceleration;
+    Rotation = newRotation;
+    AngularVelocity = newAngularVelocity;
+    AngularAcceleration = newAngularAcceleration;
+    NumSamples = FMath::Min(NumSamples + 1, 4);
+}
+
+void FExplorerCameraTelemetry::RecordModeSwitch(const UObject* Character, uint8 FromMode, uint8 ToMode, float ErrorDegrees)
+{
+    using namespace ExplorerCameraTelemetry;
+
+    ModeSwitchSummary.Count++;
+    ModeSwitchSummary.SumError += ErrorDegrees;
+    ModeSwitchSummary.MaxError = FMath::Max(ModeSwitchSummary.MaxError, ErrorDegrees);
+
+    if (ErrorDegrees > CVarModeSwitchErrorThreshold.GetValueOnGameThread())
+    {
+        ModeSwitchSummary.Flagged++;
+        UE_LOG(LogExplorer, Warning, TEXT("%s: switching from %s to %s left a %.2f degree orientation error"), *GetNameSafe(Character),
+            GetNameForCameraMode((ECharacterCameraMode::Type)FromMode), GetNameForCameraMode((ECharacterCameraMode::Type)ToMode), ErrorDegrees);
+    }
+}
+
+void FExplorerCameraTelemetry::Dump()
+{
+    using namespace ExplorerCameraTelemetry;
+
+    if (ModeSummaries.Num() == 0 && ModeSwitchSummary.Count == 0)
+    {
+        UE_LOG(LogExplorer, Log, TEXT("Camera telemetry: nothing recorded%s"), IsEnabled() ? TEXT("") : TEXT(" (Explorer.Telemetry.Enable is 0)"));
+        return;
+    }
+
+    for (TMap<uint8, FModeSummary>::TConstIterator It(ModeSummaries); It; ++It)
+    {
+        const FModeSummary& summary = It.Value();
+        UE_LOG(LogExplorer, Log, TEXT("%s: %u frames over %.1f s, angular speed avg %.1f max %.1f deg/s, max angular acceleration %.0f deg/s2, angular jerk rms %.0f max %.0f deg/s3, linear jerk rms %.0f max %.0f, %u flagged (%.2f%%)"),
+            GetNameForCameraMode((ECharacterCameraMode::Type)It.Key()), summary.Frames, summary.Seconds,
+            summary.SumAngularSpeed / FMath::Max(summary.Frames, 1u), summary.MaxAngularSpeed, summary.MaxAngularAcceleration,
+            GetRms(summary.SumSquaredAngularJerk, summary.JerkFrames), summary.MaxAngularJerk,
+            GetRms(summary.SumSquaredLinearJerk, summary.JerkFrames), summary.MaxLinearJerk,
+            summary.FlaggedFrames, 100.0 * summary.FlaggedFrames / FMath::Max(summary.Frames, 1u));
+    }
+
+    UE_LOG(LogExplorer, Log, TEXT("Camera mode switches: %u, orientation error avg %.2f max %.2f degrees, %u over threshold"),
+        ModeSwitchSummary.Count, ModeSwitchSummary.SumError / FMath::Max(ModeSwitchSummary.Count, 1u), ModeSwitchSummary.MaxError, ModeSwitchSummary.Flagged);
+}
+
+bool FExplorerCameraTelemetry::Export(const FString& Filename)
+{
+    using namespace ExplorerCameraTelemetry;
+
+    const FString filename = Filename.IsEmpty()
+        ? FPaths::ProfilingDir() / FString::Printf(TEXT("ExplorerCameraTelemetry-%s.csv"), *FDateTime::Now().ToString())
+        : Filename;
+
+    FString csv = TEXT("Mode,Frames,Seconds,AvgAngularSpeed,MaxAngularSpeed,MaxAngularAcceleration,RmsAngularJerk,MaxAngularJerk,RmsLinearJerk,MaxLinearJerk,FlaggedFrames\n");
+    for (TMap<uint8, FModeSummary>::TConstIterator It(ModeSummaries); It; ++It)
+    {
+        const FModeSummary& summary = It.Value();
+        csv += FString::Printf(TEXT("%s,%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%u\n"),
+            GetNameForCameraMode((ECharacterCameraMode::Type)It.Key()), summary.Frames, summary.Seconds,
+            summary.SumAngularSpeed / FMath::Max(summary.Frames, 1u), summary.MaxAngularSpeed, summary.MaxAngularAcceleration,
+            GetRms(summary.SumSquaredAngularJerk, summary.JerkFrames), summary.MaxAngularJerk,
+            GetRms(summary.SumSquaredLinearJerk, summary.JerkFrames), summary.MaxLinearJerk, summary.FlaggedFrames);
+    }
+
+    csv += TEXT("\nModeSwitches,AvgOrientationError,MaxOrientationError,FlaggedSwitches\n");
+    csv += FString::Printf(TEXT("%u,%.3f,%.3f,%u\n"), ModeSwitchSummary.Count,
+        ModeSwitchSummary.SumError / FMath::Max(ModeSwitchSummary.Count, 1u), ModeSwitchSummary.MaxError, ModeSwitchSummary.Flagged);
+
+    if (!FFileHelper::SaveStringToFile(csv, *filename))
+    {
+        UE_LOG(LogExplorer, Warning, TEXT("Could not write the camera telemetry to %s"), *filename);
+        return false;
+    }
+
+    UE_LOG(LogExplorer, Log, TEXT("Camera telemetry written to %s"), *filename);
+    return true;
+}
+
+void FExplorerCameraTelemetry::Reset()
+{
+    using namespace ExplorerCameraTelemetry;
+
+    ModeSummaries.Empty();
+    ModeSwitchSummary = FModeSwitchSummary();
+}
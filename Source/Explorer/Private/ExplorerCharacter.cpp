@@ -2,7 +2,24 @@
 
 #include "Explorer.h"
 #include "ExplorerCharacter.h"
+#include "ExplorerCameraCollision.h"
+#include "ExplorerSignificance.h"
+#include "ExplorerStats.h"
+#include "ExplorerPlayerInput.h"
 #include "Engine.h"
+#include "Net/UnrealNetwork.h"
+
+namespace ExplorerCharacter
+{
+    static TAutoConsoleVariable<int32> CVarLateUpdate(
+        TEXT("Explorer.Camera.LateUpdate"),
+        -1,
+        TEXT("Late camera rotation update. -1 uses each character's LateUpdateCameraRotation, 0 forces it off, 1 forces it on."));
+
+    static const FName TurnRateAxis(TEXT("TurnRate"));
+    static const FName LookUpRateAxis(TEXT("LookUpRate"));
+}
+
 //////////////////////////////////////////////////////////////////////////
 // AExplorerCharacter
 #pragma mark Constructor
@@ -32,6 +49,7 @@ AExplorerCharacter::AExplorerCharacter(const class FPostConstructInitializePrope
 	CameraBoom->AttachTo(RootComponent);
 
 	CameraBoom->bUseControllerViewRotation = true; // Rotate the arm based on the controller
+	CameraBoom->bDoCollisionTest = false; // Collision is swept asynchronously, in a batch, by FExplorerCameraCollision
 
 	// Create a follow camera
 	FollowCamera = PCIP.CreateDefaultSubobject<UCameraComponent>(this, TEXT("FollowCamera"));
@@ -40,27 +58,74 @@ AExplorerCharacter::AExplorerCharacter(const class FPostConstructInitializePrope
 
     Mesh->bCastDynamicShadow = true;
     Mesh->CastShadow = true;
+    FirstPersonBodyCastsShadow = true;
 
-    CameraFollowTurnAngleExponent = .5f;
-    CameraFollowTurnRate = .6f;
-    CameraResetSpeed = 2.f;
+    // First person arms. Hidden, and not ticked, until a first person mode is entered.
+    FirstPersonMesh = PCIP.CreateDefaultSubobject<USkeletalMeshComponent>(this, TEXT("FirstPersonMesh"));
+    FirstPersonMesh->AttachTo(FollowCamera);
+    FirstPersonMesh->bOnlyOwnerSee = true;
+    FirstPersonMesh->bCastDynamicShadow = false;
+    FirstPersonMesh->CastShadow = false;
+    FirstPersonMesh->bHiddenInGame = true;
+    FirstPersonMesh->PrimaryComponentTick.bStartWithTickEnabled = false;
 
     CameraModeEnum = ECharacterCameraMode::ThirdPersonDefault;
 
     IsResetting = false;
 
 
-    CameraZoomMaximumDistance = 600.f;
-    CameraZoomMinimumDistance = 100.f;
+    CameraProfile = NULL;
     CameraZoomCurrent = 300.f;
-    CameraZoomIncrement = 20.f;
     CameraBoom->TargetArmLength = CameraZoomCurrent;
 
-    AutoResetSmoothFollowCameraWhenIdle = true;
-    AutoResetDelaySeconds = 5.f;
+    CameraRigBlendFromArmLength = 0.f;
+    CameraRigBlendFromYaw = 0.f;
+    CameraModeSwitchPendingTelemetry = false;
+    CameraModeSwitchFromMode = 0;
+    CameraRigBlendSeconds = 0.f;
+    CameraRigBlendDuration = 0.f;
 
     IsAutoReset = false;
-    AutoResetSpeed = .15f;
+
+    IsIdle = false;
+    LastMovementTime = 0.f;
+
+    // Movement and camera work run in their own tick function, which is only enabled while there is something for it to do
+    ControllerTick.bCanEverTick = true;
+    ControllerTick.bStartWithTickEnabled = false;
+    ControllerTick.Target = NULL;
+    ControllerTickGroup = TG_PrePhysics;
+    ControllerTickInterval = 0.f;
+    CameraSimulationStepSeconds = 1.f / 60.f;
+
+    PendingForwardAxis = 0.f;
+    PendingRightAxis = 0.f;
+
+    LateUpdateCameraRotation = false;
+
+    SignificanceTickInterval = 0.f;
+    CameraCollisionSlot = INDEX_NONE;
+
+    MeshesInFirstPerson = false;
+    SignificanceLevel = EExplorerSignificance::Full;
+    MeshCastsShadowByDefault = true;
+
+    StatCounts = 0;
+
+    InputReplayStartTime = 0.0;
+    InputReplayWasBenchmarking = false;
+    InputReplayPreviousFixedDeltaTime = 0.0;
+
+    ActiveCameraMode = NULL;
+    ActiveCameraModeHasPerFrameWork = false;
+    ActiveCameraModeIsFirstPerson = false;
+
+    ReplicatedCameraState.OwnerCharacter = this;
+    IsApplyingCameraState = false;
+
+    CameraSnapshotBuffer = MakeShareable(new FExplorerCameraSnapshotBuffer());
+
+    InPawnPool = false;
 }
 
 
@@ -70,66 +135,309 @@ AExplorerCharacter::AExplorerCharacter(const class FPostConstructInitializePrope
 
 void AExplorerCharacter::CycleCamera()
 {
-    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::White, "Cycle Camera Requested");
-    int newCameraMode = (int)CameraModeEnum + 1;
-
-    if (newCameraMode >= ECharacterCameraMode::Max) newCameraMode = ECharacterCameraMode::ThirdPersonDefault;
-    SetCameraMode((ECharacterCameraMode::Type)newCameraMode);
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+    RecordInputAction(EExplorerInputTraceAction::ToggleCameraMode);
+    EXPLORER_TRACE_EVENT(this, CycleCameraRequested, CameraModeEnum, 0.f);
+    SetCameraMode((ECharacterCameraMode::Type)FExplorerCameraModeRegistry::Get().GetNextMode(CameraModeEnum));
 }
 
 void AExplorerCharacter::SetCameraMode(ECharacterCameraMode::Type newCameraMode)
 {
-    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::White, "Setting Camera Mode to " + GetNameForCameraMode(newCameraMode));
+    EXPLORER_TRACE_EVENT(this, CameraModeChanged, newCameraMode, 0.f);
+    const uint8 oldCameraMode = CameraModeEnum;
     CameraModeEnum = newCameraMode;
     UpdateForCameraMode();
+    SyncCameraState();
 
+    // A blended switch turns the body over the blend, so its error is only known once the blend ends. The blend is one
+    // continuous camera move, whose jitter is part of what telemetry measures; only a snap is a cut.
+    CameraModeSwitchPendingTelemetry = false;
+    if (FExplorerCameraTelemetry::IsEnabled())
+    {
+        if (IsCameraRigBlending())
+        {
+            CameraModeSwitchPendingTelemetry = true;
+            CameraModeSwitchFromMode = oldCameraMode;
+        }
+        else
+        {
+            FExplorerCameraTelemetry::RecordModeSwitch(this, oldCameraMode, CameraModeEnum, GetCameraModeOrientationError());
+            CameraTelemetry.Restart();
+        }
+    }
+
+    // The controller tick puts itself back to sleep if the new mode has nothing for it to do
+    WakeControllerTick();
 }
+
 void AExplorerCharacter::ResetCamera()
 {
-    if (CameraModeEnum != ECharacterCameraMode::ThirdPersonFollow) return;
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+    RecordInputAction(EExplorerInputTraceAction::ResetCamera);
+    if (ActiveCameraMode == NULL || !ActiveCameraMode->SupportsReset()) return;
 
-    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::White, "Reset Camera Requested");
-
-    IsResetting = true;
+    EXPLORER_TRACE_EVENT(this, ResetCameraRequested, CameraModeEnum, 0.f);
+    RequestCameraReset(false);
 }
 
 void AExplorerCharacter::UpdateForCameraMode()
 {
-    // Changes visibility of first and third person meshes
-    switch (CameraModeEnum)
-    {
-        case ECharacterCameraMode::ThirdPersonDefault:
-            IsResetting = false;
-            // no break is intentional
-        case ECharacterCameraMode::ThirdPersonFollow:
-            FollowCamera->AttachTo(CameraBoom, USpringArmComponent::SocketName);
-            CameraBoom->TargetArmLength = CameraZoomCurrent;
-            Mesh->SetOwnerNoSee(false);
-            bUseControllerRotationPitch = false;
-            bUseControllerRotationYaw = false;
-            bUseControllerRotationRoll = false;
-            break;
-        case ECharacterCameraMode::FirstPerson:
-            CameraBoom->TargetArmLength = 0.f;
-            IsResetting = false;
-            bUseControllerRotationPitch = true;
-            bUseControllerRotationYaw = true;
-            bUseControllerRotationRoll = true;
-            break;
-
-        default:
-            break;
+    EXPLORER_SCOPE_CYCLE_COUNTER(UpdateForCameraMode);
+
+    FExplorerCameraMode* newMode = FindOrCreateCameraMode(CameraModeEnum);
+    if (newMode == NULL)
+    {
+        // Unregistered id, e.g. a mode whose module is not loaded
+        CameraModeEnum = ECharacterCameraMode::ThirdPersonDefault;
+        newMode = FindOrCreateCameraMode(CameraModeEnum);
+    }
+
+    // The blend starts from wherever the arm is now, which may be part way through the previous blend
+    const bool bSnap = (ActiveCameraMode == NULL) || !IsLocallyControlled() || GetCameraProfile().CameraModeBlendSeconds <= 0.f;
+    CameraRigBlendFromArmLength = (ActiveCameraMode != NULL) ? GetCameraArmLength() : 0.f;
+
+    if (ActiveCameraMode != NULL)
+    {
+        ActiveCameraMode->Exit(*this);
+    }
+
+    ActiveCameraMode = newMode;
+    ActiveCameraModeHasPerFrameWork = newMode->HasPerFrameWork();
+    ActiveCameraModeIsFirstPerson = IsFirstPerson(CameraModeEnum);
+
+    // The rig's components were set up once, in the constructor. Only the pose changes from here.
+    // A rig that turns the body with the controller only takes over the body once the blend ends; until then the
+    // blend turns it, so the body does not snap to the view when entering first person
+    const FExplorerCameraRig& rig = newMode->GetRig();
+    bUseControllerRotationPitch = false;
+    bUseControllerRotationYaw = rig.bUseControllerRotationYaw && bSnap;
+    bUseControllerRotationRoll = false;
+
+    CameraRigBlendSeconds = 0.f;
+    CameraRigBlendDuration = bSnap ? 0.f : GetCameraProfile().CameraModeBlendSeconds;
+    CameraRigBlendFromYaw = GetActorRotation().Yaw;
+    ApplyCameraArmLength();
+
+    // Into first person, the body stays visible until the camera is at the head
+    if (!rig.bFirstPersonMeshes || !IsCameraRigBlending())
+    {
+        UpdateMeshesForCameraMode(rig.bFirstPersonMeshes);
+    }
+
+    newMode->Enter(*this);
+    UpdateStatCounts();
+
+    if (IsCameraRigBlending())
+    {
+        WakeControllerTick();
+    }
+}
+
+float AExplorerCharacter::GetCameraArmLength() const
+{
+    if (ActiveCameraMode == NULL) return CameraZoomCurrent;
+
+    const FExplorerCameraRig& rig = ActiveCameraMode->GetRig();
+    const float targetArmLength = rig.bArmFollowsZoom ? CameraZoomCurrent : rig.ArmLength;
+    if (!IsCameraRigBlending()) return targetArmLength;
+
+    return FMath::Lerp(CameraRigBlendFromArmLength, targetArmLength, GetCameraRigBlendAlpha());
+}
+
+float AExplorerCharacter::GetCameraRigBlendAlpha() const
+{
+    if (!IsCameraRigBlending()) return 1.f;
+
+    // Eased at both ends, so the camera neither jerks into motion nor stops dead
+    const float alpha = FMath::Clamp(CameraRigBlendSeconds / CameraRigBlendDuration, 0.f, 1.f);
+    return alpha * alpha * (3.f - 2.f * alpha);
+}
+
+void AExplorerCharacter::ApplyCameraArmLength()
+{
+    // The collision pass eases the arm back out once there is room, so only ever pull in past it here
+    CameraBoom->TargetArmLength = FExplorerCameraCollision::Get().ClampArmLength(*this, GetCameraArmLength());
+}
+
+void AExplorerCharacter::ApplyCameraRigBlendYaw()
+{
+    if (bUseControllerRotationYaw || Controller == NULL || !ActiveCameraMode->GetRig().bUseControllerRotationYaw) return;
+
+    // The control yaw can keep moving during the blend, so the body chases wherever it is now, the short way round
+    FRotator rotation = GetActorRotation();
+    rotation.Yaw = CameraRigBlendFromYaw + FRotator::NormalizeAxis(Controller->GetControlRotation().Yaw - CameraRigBlendFromYaw) * GetCameraRigBlendAlpha();
+    SetActorRotation(rotation);
+}
+
+bool AExplorerCharacter::UpdateCameraRigBlend(float DeltaSeconds)
+{
+    EXPLORER_SCOPE_CYCLE_COUNTER(CameraRigBlend);
+
+    CameraRigBlendSeconds += DeltaSeconds;
+    if (CameraRigBlendSeconds < CameraRigBlendDuration)
+    {
+        ApplyCameraArmLength();
+        ApplyCameraRigBlendYaw();
+        return true;
+    }
+
+    CameraRigBlendDuration = 0.f;
+    ApplyCameraArmLength();
+
+    // The last step of the body turn, then the controller takes over
+    const FExplorerCameraRig& rig = ActiveCameraMode->GetRig();
+    ApplyCameraRigBlendYaw();
+    bUseControllerRotationYaw = rig.bUseControllerRotationYaw;
+    if (rig.bFirstPersonMeshes)
+    {
+        UpdateMeshesForCameraMode(true);
+    }
+    UpdateStatCounts();
+
+    if (CameraModeSwitchPendingTelemetry)
+    {
+        CameraModeSwitchPendingTelemetry = false;
+        FExplorerCameraTelemetry::RecordModeSwitch(this, CameraModeSwitchFromMode, CameraModeEnum, GetCameraModeOrientationError());
+    }
+    return false;
+}
+
+FExplorerCameraMode* AExplorerCharacter::FindOrCreateCameraMode(uint8 ModeId)
+{
+    if (ModeId < CameraModeInstances.Num() && CameraModeInstances[ModeId].IsValid())
+    {
+        return CameraModeInstances[ModeId].Get();
+    }
+
+    const FExplorerCameraModeInfo* info = FExplorerCameraModeRegistry::Get().Find(ModeId);
+    if (info == NULL) return NULL;
+
+    if (ModeId >= CameraModeInstances.Num())
+    {
+        CameraModeInstances.SetNum(ModeId + 1);
+    }
+    CameraModeInstances[ModeId] = info->Factory();
+    return CameraModeInstances[ModeId].Get();
+}
+
+void AExplorerCharacter::UpdateMeshesForCameraMode(bool bFirstPerson)
+{
+    MeshesInFirstPerson = bFirstPerson;
+    RefreshMeshSettings();
+}
+
+void AExplorerCharacter::SetSignificanceLevel(EExplorerSignificance::Type Level)
+{
+    SignificanceLevel = Level;
+    RefreshMeshSettings();
+}
+
+void AExplorerCharacter::RefreshMeshSettings()
+{
+    // Only the owner sees the difference. Everyone else keeps seeing (and animating) the full third person mesh.
+    const bool bOwnerInFirstPerson = MeshesInFirstPerson && IsLocallyControlled();
+
+    // Arms: visible and animated only in first person. With its tick off the mesh does no bone evaluation at all.
+    FirstPersonMesh->SetHiddenInGame(!bOwnerInFirstPerson);
+    FirstPersonMesh->SetComponentTickEnabled(bOwnerInFirstPerson);
+
+    // Body: hidden from the owner in first person, and either reduced to a shadow caster with update rate
+    // optimizations, or switched off entirely
+    const bool bBodyShadowOnly = bOwnerInFirstPerson && FirstPersonBodyCastsShadow;
+    Mesh->SetOwnerNoSee(MeshesInFirstPerson);
+    Mesh->bCastHiddenShadow = bBodyShadowOnly;
+    Mesh->SetComponentTickEnabled(!bOwnerInFirstPerson || FirstPersonBodyCastsShadow);
+
+    // Significance: update rate optimizations below full detail, no pose ticking for unrendered minimal meshes, and
+    // shadows only down to reduced detail
+    Mesh->bEnableUpdateRateOptimizations = bBodyShadowOnly || SignificanceLevel != EExplorerSignificance::Full;
+    Mesh->MeshComponentUpdateFlag = (SignificanceLevel == EExplorerSignificance::Minimal) ? EMeshComponentUpdateFlag::OnlyTickPoseWhenRendered : EMeshComponentUpdateFlag::AlwaysTickPoseAndRefreshBones;
+    Mesh->CastShadow = MeshCastsShadowByDefault && (!bOwnerInFirstPerson || FirstPersonBodyCastsShadow) && SignificanceLevel != EExplorerSignificance::Minimal;
+    Mesh->MarkRenderStateDirty();
+}
+
+void AExplorerCharacter::PublishCameraSnapshot(const FVector& ViewLocation, const FRotator& ViewRotation)
+{
+    FExplorerCameraSnapshot snapshot;
+    snapshot.FrameNumber = GFrameCounter;
+    snapshot.PublishedSeconds = FPlatformTime::Seconds();
+    snapshot.ViewLocation = ViewLocation;
+    snapshot.ViewRotation = ViewRotation;
+    snapshot.Zoom = CameraZoomCurrent;
+    snapshot.IdleSeconds = (GetWorld() != NULL) ? GetInputIdleSeconds() : 0.f;
+    snapshot.CameraMode = CameraModeEnum;
+    snapshot.bFirstPerson = ActiveCameraModeIsFirstPerson;
+    snapshot.bResetting = IsResetting;
+    snapshot.bAutoReset = IsAutoReset;
+    CameraSnapshotBuffer->Publish(snapshot);
+}
+
+void AExplorerCharacter::PublishCameraSnapshot()
+{
+    PublishCameraSnapshot(FollowCamera->GetComponentLocation(), FollowCamera->GetComponentRotation());
+}
+
+float AExplorerCharacter::GetCameraModeOrientationError() const
+{
+    const FRotator actorRotation = GetActorRotation();
+    float error = FMath::Max(FMath::Abs(FRotator::NormalizeAxis(actorRotation.Pitch)), FMath::Abs(FRotator::NormalizeAxis(actorRotation.Roll)));
+
+    if (ActiveCameraModeIsFirstPerson && Controller != NULL)
+    {
+        error = FMath::Max(error, FMath::Abs(FRotator::NormalizeAxis(actorRotation.Yaw - Controller->GetControlRotation().Yaw)));
+    }
+    return error;
+}
+
+void AExplorerCharacter::UpdateStatCounts()
+{
+    uint8 counts = 0;
+    if (ActiveCameraMode != NULL && !IsPendingKill())
+    {
+        if (CameraModeEnum == ECharacterCameraMode::ThirdPersonFollow) counts |= FExplorerStats::FollowCount;
+        if (IsResetting) counts |= FExplorerStats::ResettingCount;
+        if (ActiveCameraModeIsFirstPerson) counts |= FExplorerStats::FirstPersonCount;
+        if (IsCameraRigBlending()) counts |= FExplorerStats::BlendingCount;
+    }
+
+    if (counts != StatCounts)
+    {
+        FExplorerStats::UpdateCharacterCounts(StatCounts, counts);
+        StatCounts = counts;
     }
 }
 
 bool AExplorerCharacter::IsInFirstPersonMode()
 {
-    return IsFirstPerson(CameraModeEnum);
+    return ActiveCameraModeIsFirstPerson;
 }
 
 bool AExplorerCharacter::IsInThirdPersonMode()
 {
-    return IsThirdPerson(CameraModeEnum);
+    return !ActiveCameraModeIsFirstPerson;
+}
+
+void AExplorerCharacter::RequestCameraReset(bool bAutomatic)
+{
+    if (ActiveCameraMode == NULL || !ActiveCameraMode->SupportsReset()) return;
+    if (bAutomatic && !GetCameraProfile().AutoResetSmoothFollowCameraWhenIdle) return;
+
+    // Resets are driven by the owner's control rotation. Everyone else just sees the replicated flags.
+    if (!IsLocallyControlled()) return;
+
+    IsAutoReset = bAutomatic;
+    IsResetting = true;
+    WakeControllerTick();
+    UpdateStatCounts();
+    SyncCameraState();
+}
+
+void AExplorerCharacter::CancelCameraReset()
+{
+    IsResetting = false;
+    IsAutoReset = false;
+    UpdateStatCounts();
+    SyncCameraState();
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -137,21 +445,31 @@ bool AExplorerCharacter::IsInThirdPersonMode()
 #pragma mark - Camera Zoom
 void AExplorerCharacter::ZoomCameraIn()
 {
-    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::White, "Zoom Camera In Requested");
-    CameraZoomCurrent-=CameraZoomIncrement;
-    if (CameraZoomCurrent < CameraZoomMinimumDistance)
-        CameraZoomCurrent = CameraZoomMinimumDistance;
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+    RecordInputAction(EExplorerInputTraceAction::ZoomIn);
+    const UExplorerCameraProfile& profile = GetCameraProfile();
+    CameraZoomCurrent-=profile.CameraZoomIncrement;
+    if (CameraZoomCurrent < profile.CameraZoomMinimumDistance)
+        CameraZoomCurrent = profile.CameraZoomMinimumDistance;
 
-    CameraBoom->TargetArmLength = CameraZoomCurrent;
+    EXPLORER_TRACE_EVENT(this, ZoomCameraIn, CameraModeEnum, CameraZoomCurrent);
+
+    ApplyCameraArmLength();
+    SyncCameraState();
 }
 void AExplorerCharacter::ZoomCameraOut()
 {
-    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::White, "Zoom Camera Out Requested");
-    CameraZoomCurrent+=CameraZoomIncrement;
-    if (CameraZoomCurrent > CameraZoomMaximumDistance)
-        CameraZoomCurrent = CameraZoomMaximumDistance;
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+    RecordInputAction(EExplorerInputTraceAction::ZoomOut);
+    const UExplorerCameraProfile& profile = GetCameraProfile();
+    CameraZoomCurrent+=profile.CameraZoomIncrement;
+    if (CameraZoomCurrent > profile.CameraZoomMaximumDistance)
+        CameraZoomCurrent = profile.CameraZoomMaximumDistance;
 
-    CameraBoom->TargetArmLength = CameraZoomCurrent;
+    EXPLORER_TRACE_EVENT(this, ZoomCameraOut, CameraModeEnum, CameraZoomCurrent);
+
+    ApplyCameraArmLength();
+    SyncCameraState();
 }
 
 
@@ -161,93 +479,163 @@ void AExplorerCharacter::ZoomCameraOut()
 
 void AExplorerCharacter::TurnAtRate(float Rate)
 {
-    if (Rate == 0.f) return;
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+    RecordInputAxis(EExplorerInputTraceAxis::TurnRate, Rate);
+
+    // Consumed even while resetting, so the reset does not leave a backlog of turning behind
+    const float rateSeconds = ConsumeRateAxisSeconds(ExplorerCharacter::TurnRateAxis, Rate);
+    if (rateSeconds == 0.f) return;
 
-	// calculate delta for this frame from the rate information
     if (!IsResetting)
     {
-        LastMovementTime = FApp::GetCurrentTime();
-        AddControllerYawInput(Rate * BaseTurnRate * GetWorld()->GetDeltaSeconds());
+        NoteInputActivity();
+        LookLatency.NoteLookInput();
+        AddControllerYawInput(rateSeconds * BaseTurnRate);
     }
 }
 
 void AExplorerCharacter::LookUpAtRate(float Rate)
 {
-    if (Rate == 0.f) return;
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+    RecordInputAxis(EExplorerInputTraceAxis::LookUpRate, Rate);
+
+    const float rateSeconds = ConsumeRateAxisSeconds(ExplorerCharacter::LookUpRateAxis, Rate);
+    if (rateSeconds == 0.f) return;
 
-    LastMovementTime = FApp::GetCurrentTime();
-	AddControllerPitchInput(Rate * BaseLookUpRate * GetWorld()->GetDeltaSeconds());
+    NoteInputActivity();
+    LookLatency.NoteLookInput();
+    AddControllerPitchInput(rateSeconds * BaseLookUpRate);
 }
 
-void AExplorerCharacter::MoveForward(float Value)
+float AExplorerCharacter::ConsumeRateAxisSeconds(FName AxisName, float Rate)
 {
-    if (Value == 0.f) return;
+    // Live input integrated from timestamped events, when the player input does that
+    const APlayerController* playerController = IsReplayingInputTrace() ? NULL : Cast<APlayerController>(Controller);
+    UExplorerPlayerInput* playerInput = (playerController != NULL) ? Cast<UExplorerPlayerInput>(playerController->PlayerInput) : NULL;
 
-    if (IsInThirdPersonMode())
-    {
-        if (Controller != NULL)
-        {
-            // find out which way is forward
-            const FRotator Rotation = Controller->GetControlRotation();
-            const FRotator YawRotation(0, Rotation.Yaw, 0);
-
-            // get forward vector
-            const FVector Direction = FRotationMatrix(YawRotation).GetUnitAxis(EAxis::X);
-            AddMovementInput(Direction, Value);
-        }
-    }
-    else
+    const float deltaSeconds = GetWorld()->GetDeltaSeconds();
+    float valueSeconds = 0.f;
+    if (playerInput != NULL && playerInput->ConsumeIntegratedAxis(AxisName, Rate, deltaSeconds, valueSeconds))
     {
-            AddMovementInput(GetActorForwardVector(), Value);
+        return valueSeconds;
     }
-    LastMovementTime = FApp::GetCurrentTime();
 
+    // Otherwise this frame's value is taken to have held for the whole frame
+    return Rate * deltaSeconds;
 }
 
-void AExplorerCharacter::MoveRight(float Value)
+void AExplorerCharacter::MoveForward(float Value)
 {
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+    RecordInputAxis(EExplorerInputTraceAxis::MoveForward, Value);
+
+    // Applied once per frame, together with MoveRight, in GatherMovementIntent
+    PendingForwardAxis = Value;
     if (Value == 0.f) return;
 
-    if (IsInThirdPersonMode())
-    {
-        if ( Controller != NULL )
-        {
-            // find out which way is right
-            const FRotator Rotation = Controller->GetControlRotation();
-            const FRotator YawRotation(0, Rotation.Yaw, 0);
-
-            // get right vector
-            const FVector Direction = FRotationMatrix(YawRotation).GetUnitAxis(EAxis::Y);
-            // add movement in that direction
-            AddMovementInput(Direction, Value);
-        }
-    }
-    else
-    {
-            AddMovementInput(GetActorRightVector(), Value);
+    NoteInputActivity();
+    WakeControllerTick();
+}
 
-    }
-    LastMovementTime = FApp::GetCurrentTime();
+void AExplorerCharacter::MoveRight(float Value)
+{
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+    RecordInputAxis(EExplorerInputTraceAxis::MoveRight, Value);
+
+    // Applied once per frame, together with MoveForward, in GatherMovementIntent
+    PendingRightAxis = Value;
+    if (Value == 0.f) return;
 
+    NoteInputActivity();
+    WakeControllerTick();
 }
 
 void AExplorerCharacter::HandleYawInput(float turnInput)
 {
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+    RecordInputAxis(EExplorerInputTraceAxis::Turn, turnInput);
     if (!IsResetting)
     {
         if (turnInput != 0.f)
         {
             AddControllerYawInput(turnInput);
-            LastMovementTime = FApp::GetCurrentTime();
+            NoteInputActivity();
+            LookLatency.NoteLookInput();
         }
 
     }
 }
 
+void AExplorerCharacter::HandlePitchInput(float lookUpInput)
+{
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+    RecordInputAxis(EExplorerInputTraceAxis::LookUp, lookUpInput);
+    if (lookUpInput == 0.f) return;
+
+    AddControllerPitchInput(lookUpInput);
+    NoteInputActivity();
+    LookLatency.NoteLookInput();
+}
+
 void AExplorerCharacter::HandleJump()
 {
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+    RecordInputAction(EExplorerInputTraceAction::Jump);
     Super::Jump();
-    LastMovementTime = FApp::GetCurrentTime();
+    NoteInputActivity();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Idle Tracking
+#pragma mark - Idle Tracking
+
+bool AExplorerCharacter::IsInputIdle() const
+{
+    return IsIdle;
+}
+
+float AExplorerCharacter::GetInputIdleSeconds() const
+{
+    return GetWorld()->GetTimeSeconds() - LastMovementTime;
+}
+
+void AExplorerCharacter::NoteInputActivity()
+{
+    // Only the activity time is stored here. The running timer is left alone and catches up with the new
+    // deadline when it expires, so continuous input never touches the timer manager.
+    LastMovementTime = GetWorld()->GetTimeSeconds();
+
+    if (IsIdle)
+    {
+        IsIdle = false;
+        ArmIdleTimer(GetCameraProfile().AutoResetDelaySeconds);
+    }
+}
+
+void AExplorerCharacter::ArmIdleTimer(float Seconds)
+{
+    // Setting a timer copies its delegate to the heap. That is at most twice per idle cycle (continuous input never
+    // re-arms it, see NoteInputActivity), and the timer manager offers no way to re-arm a timer in place.
+    FExplorerAllocationExemption allocationExemption;
+
+    // A zero rate would clear the timer instead of firing it
+    GetWorldTimerManager().SetTimer(this, &AExplorerCharacter::OnIdleTimerExpired, FMath::Max(Seconds, KINDA_SMALL_NUMBER), false);
+}
+
+void AExplorerCharacter::OnIdleTimerExpired()
+{
+    // Input arrived after the timer was armed, so the real deadline is later
+    const float remainingSeconds = LastMovementTime + GetCameraProfile().AutoResetDelaySeconds - GetWorld()->GetTimeSeconds();
+    if (remainingSeconds > KINDA_SMALL_NUMBER)
+    {
+        ArmIdleTimer(remainingSeconds);
+        return;
+    }
+
+    IsIdle = true;
+    EXPLORER_TRACE_EVENT(this, IdleTimerExpired, CameraModeEnum, GetCameraProfile().AutoResetDelaySeconds);
+
+    RequestCameraReset(true);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -256,11 +644,14 @@ void AExplorerCharacter::HandleJump()
 
 void AExplorerCharacter::TouchStarted(ETouchIndex::Type FingerIndex, FVector Location)
 {
+    EXPLORER_SCOPE_CYCLE_COUNTER(Input);
+
 	// jump, but only on the first touch
 	if (FingerIndex == ETouchIndex::Touch1)
 	{
+        RecordInputAction(EExplorerInputTraceAction::Touch);
 		Jump();
-        LastMovementTime = FApp::GetCurrentTime();
+        NoteInputActivity();
 	}
 }
 
@@ -284,11 +675,298 @@ void AExplorerCharacter::SetupPlayerInputComponent(class UInputComponent* InputC
 
 	InputComponent->BindAxis("Turn", this, &AExplorerCharacter::HandleYawInput);
 	InputComponent->BindAxis("TurnRate", this, &AExplorerCharacter::TurnAtRate);
-	InputComponent->BindAxis("LookUp", this, &APawn::AddControllerPitchInput);
+	InputComponent->BindAxis("LookUp", this, &AExplorerCharacter::HandlePitchInput);
 	InputComponent->BindAxis("LookUpRate", this, &AExplorerCharacter::LookUpAtRate);
 
 	// handle touch devices
 	InputComponent->BindTouch(EInputEvent::IE_Pressed, this, &AExplorerCharacter::TouchStarted);
+
+    // -ExplorerRecordInput=<file> and -ExplorerReplayInput=<file> start a trace as soon as the player has control
+    FString traceFilename;
+    if (FParse::Value(FCommandLine::Get(), TEXT("ExplorerReplayInput="), traceFilename))
+    {
+        ReplayInputTrace(traceFilename);
+    }
+    else if (FParse::Value(FCommandLine::Get(), TEXT("ExplorerRecordInput="), traceFilename))
+    {
+        RecordInputTrace(traceFilename);
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Input Trace
+#pragma mark - Input Trace
+
+void AExplorerCharacter::RecordInputTrace(const FString& Filename)
+{
+    StopInputTrace();
+
+    FString traceFilename = Filename;
+    if (traceFilename.IsEmpty())
+    {
+        traceFilename = FPaths::GameSavedDir() / TEXT("InputTraces") / FString::Printf(TEXT("Explorer-%s.extrace"), *FDateTime::Now().ToString());
+    }
+
+    FExplorerInputTraceHeader header;
+    header.StartTicks = FDateTime::Now().GetTicks();
+    header.Location = GetActorLocation();
+    header.Rotation = GetActorRotation();
+    header.ControlRotation = (Controller != NULL) ? Controller->GetControlRotation() : FRotator::ZeroRotator;
+    header.CameraZoom = CameraZoomCurrent;
+    header.CameraMode = CameraModeEnum;
+
+    InputTraceWriter = FExplorerInputTraceWriter::Create(traceFilename, header);
+    if (InputTraceWriter.IsValid())
+    {
+        UE_LOG(LogExplorer, Log, TEXT("Recording input trace to %s"), *traceFilename);
+    }
+    UpdatePrimaryTickEnabled();
+}
+
+void AExplorerCharacter::StopInputTrace()
+{
+    if (InputTraceWriter.IsValid())
+    {
+        UE_LOG(LogExplorer, Log, TEXT("Recorded %d frames to input trace %s"), InputTraceWriter->GetNumFrames(), *InputTraceWriter->GetFilename());
+        InputTraceWriter->Close();
+        InputTraceWriter.Reset();
+    }
+
+    if (InputTraceReader.IsValid())
+    {
+        FinishInputReplay();
+    }
+
+    UpdatePrimaryTickEnabled();
+}
+
+void AExplorerCharacter::ReplayInputTrace(const FString& Filename)
+{
+    StopInputTrace();
+
+    InputTraceReader = FExplorerInputTraceReader::Open(Filename);
+    if (!InputTraceReader.IsValid()) return;
+
+    // Restore the state the recording started from
+    const FExplorerInputTraceHeader& header = InputTraceReader->GetHeader();
+    SetActorLocationAndRotation(header.Location, header.Rotation);
+    if (Controller != NULL)
+    {
+        Controller->SetControlRotation(header.ControlRotation);
+    }
+    CameraZoomCurrent = header.CameraZoom;
+    IsResetting = false;
+    IsAutoReset = false;
+    NoteInputActivity();
+    SetCameraMode((ECharacterCameraMode::Type)FMath::Min<uint8>(header.CameraMode, ECharacterCameraMode::Max - 1));
+
+    // Live input is ignored for the duration of the replay. The controller rebuilds its input stack every frame, so
+    // the pawn's InputComponent can't just be popped; disabling input keeps it out of the stack until the replay ends.
+    APlayerController* playerController = Cast<APlayerController>(Controller);
+    if (playerController != NULL)
+    {
+        DisableInput(playerController);
+    }
+
+    // Lock the engine to the recorded frame times. The engine uses the fixed delta for the frame after the one
+    // that sets it, so each frame primes the delta for the frame that will be applied next.
+    InputReplayWasBenchmarking = FApp::IsBenchmarking();
+    InputReplayPreviousFixedDeltaTime = FApp::GetFixedDeltaTime();
+    FApp::SetBenchmarking(true);
+
+    FExplorerInputTraceFrame firstFrame;
+    if (InputTraceReader->PeekFrame(firstFrame))
+    {
+        FApp::SetFixedDeltaTime(firstFrame.DeltaSeconds);
+    }
+
+    InputReplayFrame.Reset();
+    InputReplayStartTime = FPlatformTime::Seconds();
+    UpdatePrimaryTickEnabled();
+    UE_LOG(LogExplorer, Log, TEXT("Replaying input trace %s"), *Filename);
+}
+
+void AExplorerCharacter::ApplyInputReplayFrame()
+{
+    if (!InputTraceReader->ReadFrame(InputReplayFrame))
+    {
+        FinishInputReplay();
+        return;
+    }
+
+    FExplorerInputTraceFrame nextFrame;
+    if (InputTraceReader->PeekFrame(nextFrame))
+    {
+        FApp::SetFixedDeltaTime(nextFrame.DeltaSeconds);
+    }
+
+    ApplyInputFrame(InputReplayFrame);
+}
+
+void AExplorerCharacter::ApplyInputFrame(const FExplorerInputTraceFrame& frame)
+{
+    // Same order the input component dispatches bindings in: actions first, then axes
+    if (frame.HasAction(EExplorerInputTraceAction::Jump)) HandleJump();
+    if (frame.HasAction(EExplorerInputTraceAction::ResetCamera)) ResetCamera();
+    if (frame.HasAction(EExplorerInputTraceAction::ToggleCameraMode)) CycleCamera();
+    if (frame.HasAction(EExplorerInputTraceAction::ZoomIn)) ZoomCameraIn();
+    if (frame.HasAction(EExplorerInputTraceAction::ZoomOut)) ZoomCameraOut();
+    if (frame.HasAction(EExplorerInputTraceAction::Touch)) TouchStarted(ETouchIndex::Touch1, FVector::ZeroVector);
+
+    MoveForward(frame.Axes[EExplorerInputTraceAxis::MoveForward]);
+    MoveRight(frame.Axes[EExplorerInputTraceAxis::MoveRight]);
+    HandleYawInput(frame.Axes[EExplorerInputTraceAxis::Turn]);
+    TurnAtRate(frame.Axes[EExplorerInputTraceAxis::TurnRate]);
+    HandlePitchInput(frame.Axes[EExplorerInputTraceAxis::LookUp]);
+    LookUpAtRate(frame.Axes[EExplorerInputTraceAxis::LookUpRate]);
+}
+
+void AExplorerCharacter::FinishInputReplay()
+{
+    const double wallSeconds = FPlatformTime::Seconds() - InputReplayStartTime;
+    const int32 numFrames = InputTraceReader->GetNumFramesRead();
+    UE_LOG(LogExplorer, Log, TEXT("Replayed %d frames from %s in %.2fs (%.3f ms/frame)"), numFrames, *InputTraceReader->GetFilename(), wallSeconds, numFrames > 0 ? wallSeconds * 1000.0 / numFrames : 0.0);
+
+    InputTraceReader.Reset();
+    InputReplayFrame.Reset();
+
+    FApp::SetBenchmarking(InputReplayWasBenchmarking);
+    FApp::SetFixedDeltaTime(InputReplayPreviousFixedDeltaTime);
+
+    APlayerController* playerController = Cast<APlayerController>(Controller);
+    if (playerController != NULL)
+    {
+        EnableInput(playerController);
+    }
+
+    // -ExplorerReplayExit turns a replay into a one shot benchmark / regression run
+    if (FParse::Param(FCommandLine::Get(), TEXT("ExplorerReplayExit")))
+    {
+        FExplorerStats::ExitHeadlessRun(TEXT("Input trace replay"));
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Replication
+#pragma mark - Replication
+
+void AExplorerCharacter::SyncCameraState()
+{
+    PublishCameraSnapshot();
+
+    if (IsApplyingCameraState) return;
+
+    if (Role == ROLE_Authority)
+    {
+        // Property replication only sends this to a connection when it differs from what that connection has
+        ReplicatedCameraState.SetState(CameraModeEnum, CameraZoomCurrent, IsResetting, IsAutoReset);
+    }
+    else if (IsLocallyControlled())
+    {
+        FExplorerReplicatedCameraState state;
+        state.OwnerCharacter = this;
+        state.SetState(CameraModeEnum, CameraZoomCurrent, IsResetting, IsAutoReset);
+
+        // A mode switch cancels any reset and then sets the mode, which would otherwise be two messages
+        if (state == LastSentCameraState) return;
+
+        LastSentCameraState = state;
+        ServerSetCameraState(state);
+    }
+}
+
+void AExplorerCharacter::ApplyCameraState(const FExplorerReplicatedCameraState& State)
+{
+    IsApplyingCameraState = true;
+
+    CameraZoomCurrent = State.GetZoom();
+    if (ActiveCameraMode == NULL || State.CameraMode != CameraModeEnum)
+    {
+        EXPLORER_TRACE_EVENT(this, CameraModeChanged, State.CameraMode, 0.f);
+        CameraModeEnum = (ECharacterCameraMode::Type)State.CameraMode;
+        UpdateForCameraMode();
+    }
+    else
+    {
+        ApplyCameraArmLength();
+    }
+    IsResetting = State.IsResetting();
+    IsAutoReset = State.IsAutoReset();
+    UpdateStatCounts();
+
+    IsApplyingCameraState = false;
+    PublishCameraSnapshot();
+
+    if (IsResetting && IsLocallyControlled())
+    {
+        WakeControllerTick();
+    }
+}
+
+void AExplorerCharacter::OnRep_ReplicatedCameraState()
+{
+    UNetDriver* netDriver = GetWorld()->GetNetDriver();
+    FExplorerNetStats::RecordReceived(netDriver != NULL ? netDriver->ServerConnection : NULL, this, FExplorerReplicatedCameraState::NumBits);
+
+    ApplyCameraState(ReplicatedCameraState);
+}
+
+bool AExplorerCharacter::ServerSetCameraState_Validate(FExplorerReplicatedCameraState State)
+{
+    return FExplorerCameraModeRegistry::Get().Find(State.CameraMode) != NULL;
+}
+
+void AExplorerCharacter::ServerSetCameraState_Implementation(FExplorerReplicatedCameraState State)
+{
+    FExplorerNetStats::RecordReceived(GetNetConnection(), this, FExplorerReplicatedCameraState::NumBits);
+
+    FExplorerReplicatedCameraState accepted;
+    accepted.SetState(State.CameraMode, FMath::Clamp(State.GetZoom(), GetCameraProfile().CameraZoomMinimumDistance, GetCameraProfile().CameraZoomMaximumDistance), State.IsResetting(), State.IsAutoReset());
+
+    ApplyCameraState(accepted);
+    SyncCameraState();
+
+    // The owner is skipped by property replication, so it only hears back when its prediction was wrong
+    if (!(accepted == State))
+    {
+        ClientCorrectCameraState(ReplicatedCameraState);
+    }
+}
+
+void AExplorerCharacter::ClientCorrectCameraState_Implementation(FExplorerReplicatedCameraState State)
+{
+    FExplorerNetStats::RecordReceived(GetNetConnection(), this, FExplorerReplicatedCameraState::NumBits);
+
+    LastSentCameraState = State;
+    ApplyCameraState(State);
+}
+
+void AExplorerCharacter::Destroyed()
+{
+    Super::Destroyed();
+
+    UpdateStatCounts();
+}
+
+void AExplorerCharacter::BeginDestroy()
+{
+    // Characters that are unloaded with their level are never Destroyed()
+    if (StatCounts != 0)
+    {
+        FExplorerStats::UpdateCharacterCounts(StatCounts, 0);
+        StatCounts = 0;
+    }
+
+    Super::BeginDestroy();
+}
+
+void AExplorerCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    DOREPLIFETIME_CONDITION(AExplorerCharacter, ReplicatedCameraState, COND_SkipOwner);
 }
 
 
@@ -296,81 +974,418 @@ void AExplorerCharacter::SetupPlayerInputComponent(class UInputComponent* InputC
 // AActor Overrides
 #pragma mark - AActor Overrides
 
-void AExplorerCharacter::Tick(float DeltaSeconds)
+void AExplorerCharacter::PostInitializeComponents()
 {
+    Super::PostInitializeComponents();
 
-    Super::Tick(DeltaSeconds);
+    // Before any camera mode or significance level has touched it
+    MeshCastsShadowByDefault = Mesh->CastShadow;
+}
 
-    if (CameraModeEnum != ECharacterCameraMode::ThirdPersonFollow) return;
+void AExplorerCharacter::BeginPlay()
+{
+    Super::BeginPlay();
 
-    const FRotator Rotation = Controller->GetControlRotation();
+    // Every mode is created up front, so that the first switch into one does not allocate mid-game
+    for (int32 ModeId = 0; ModeId < FExplorerCameraModeRegistry::MaxModes; ModeId++)
+    {
+        FindOrCreateCameraMode((uint8)ModeId);
+    }
 
-    float currentTime = FApp::GetCurrentTime();
-//    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::White, FString::Printf(TEXT("current time: %f"), currentTime));
-//    GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::White, FString::Printf(TEXT("last movement time: %f"), LastMovementTime));
-    if (currentTime > LastMovementTime + AutoResetDelaySeconds)
+    // Pooled before play started. Tick functions registered since then start enabled, so they are put back to sleep.
+    if (InPawnPool)
     {
-        IsAutoReset = true;
-        IsResetting = true;
+        SetPooledComponentsActive(false);
+        return;
     }
 
+    StartPlaying();
+}
+
+void AExplorerCharacter::StartPlaying()
+{
+    // Enter the starting camera mode, which may have been changed from its default in a Blueprint or the editor
+    UpdateForCameraMode();
+    SyncCameraState();
+
+    LastMovementTime = GetWorld()->GetTimeSeconds();
+    IsIdle = false;
+    ArmIdleTimer(GetCameraProfile().AutoResetDelaySeconds);
+
+    FExplorerCameraCollision::Get().Register(this);
+    FExplorerSignificance::Get().Register(this);
+    FExplorerStats::Initialize();
+
+    UpdatePrimaryTickEnabled();
+}
 
-    if (IsResetting)
+//////////////////////////////////////////////////////////////////////////
+// Pawn Pool
+#pragma mark - Pawn Pool
+
+void AExplorerCharacter::EnterPawnPool()
+{
+    InPawnPool = true;
+
+    // Without an active mode the character drops out of the camera mode counts, and the next mode is entered without a blend
+    if (ActiveCameraMode != NULL)
     {
+        ActiveCameraMode->Exit(*this);
+        ActiveCameraMode = NULL;
+    }
+    CameraRigBlendDuration = 0.f;
+    CameraModeSwitchPendingTelemetry = false;
+    IsResetting = false;
+    IsAutoReset = false;
+    UpdateStatCounts();
 
-        FRotator meshRotation = Mesh->GetTransformMatrix().Rotator();
-        meshRotation.Yaw += 90.f;
-        meshRotation.Pitch = Controller->GetControlRotation().Pitch;
+    GetWorldTimerManager().ClearTimer(this, &AExplorerCharacter::OnIdleTimerExpired);
+    CharacterMovement->StopMovementImmediately();
+    SetPooledComponentsActive(false);
 
-        float delta = meshRotation.Yaw - Rotation.Yaw;
+    // A hidden pawn must not take budget slots or sweeps from live ones. StartPlaying registers it again, from scratch.
+    FExplorerCameraCollision::Get().Unregister(this);
+    FExplorerSignificance::Get().Unregister(this);
+}
 
+void AExplorerCharacter::LeavePawnPool(const FVector& Location, const FRotator& Rotation)
+{
+    InPawnPool = false;
+
+    TeleportTo(Location, Rotation, false, true);
+    SetPooledComponentsActive(true);
+    CharacterMovement->SetDefaultMovementMode();
+
+    // Back to the camera a newly spawned character would have
+    const AExplorerCharacter* defaults = GetClass()->GetDefaultObject<AExplorerCharacter>();
+    CameraModeEnum = defaults->CameraModeEnum;
+    CameraZoomCurrent = defaults->CameraZoomCurrent;
+    PendingForwardAxis = 0.f;
+    PendingRightAxis = 0.f;
+    MovementIntent = FExplorerMovementIntent();
+    LastSentCameraState = FExplorerReplicatedCameraState();
+    CameraTelemetry.Restart();
+
+    // Characters pooled before play started are started by BeginPlay
+    if (GetWorld()->HasBegunPlay())
+    {
+        StartPlaying();
+    }
+}
 
-        // Prevent going "the long way around"
-        if (fabsf(delta) >= 180.f)
-        {
-            if (delta <= 0.f)
-                delta +=360.f;
-            else
-                delta -= 360.f;
-        }
+void AExplorerCharacter::SetPooledComponentsActive(bool bActive)
+{
+    SetActorHiddenInGame(!bActive);
+    SetActorEnableCollision(bActive);
+    CharacterMovement->SetComponentTickEnabled(bActive);
+    SetNetDormancy(bActive ? DORM_Awake : DORM_DormantAll);
 
-        if (fabsf(delta) <= 1.f)
+    // Coming out of the pool, entering the camera mode sets up the mesh ticks and StartPlaying the primary tick
+    if (!bActive)
+    {
+        Mesh->SetComponentTickEnabled(false);
+        FirstPersonMesh->SetComponentTickEnabled(false);
+        PrimaryActorTick.SetTickFunctionEnable(false);
+        SleepControllerTick();
+    }
+}
+
+void AExplorerCharacter::RegisterActorTickFunctions(bool bRegister)
+{
+    Super::RegisterActorTickFunctions(bRegister);
+
+    if (bRegister)
+    {
+        if (ControllerTick.bCanEverTick)
         {
-            IsResetting = false;
-            IsAutoReset = false;
+            ControllerTick.Target = this;
+            ControllerTick.TickGroup = ControllerTickGroup;
+            UpdateControllerTickInterval();
+            ControllerTick.SetTickFunctionEnable(false);
+            ControllerTick.RegisterTickFunction(GetLevel());
+
+            // Replayed input is applied in the primary tick, so the controller tick has to run after it,
+            // and the movement component has to run after the controller tick has added this frame's input
+            ControllerTick.AddPrerequisite(this, PrimaryActorTick);
+            CharacterMovement->PrimaryComponentTick.AddPrerequisite(this, ControllerTick);
         }
-        else
+    }
+    else if (ControllerTick.IsTickFunctionRegistered())
+    {
+        ControllerTick.UnRegisterTickFunction();
+    }
+}
+
+void AExplorerCharacter::SetControllerTickPrerequisite(AController* NewController)
+{
+    AController* previousController = ControllerTickPrerequisite.Get();
+    if (previousController == NewController) return;
+
+    if (previousController != NULL)
+    {
+        ControllerTick.RemovePrerequisite(previousController, previousController->PrimaryActorTick);
+    }
+
+    if (NewController != NULL)
+    {
+        ControllerTick.AddPrerequisite(NewController, NewController->PrimaryActorTick);
+    }
+
+    ControllerTickPrerequisite = NewController;
+}
+
+void AExplorerCharacter::PossessedBy(AController* NewController)
+{
+    Super::PossessedBy(NewController);
+
+    // The primary tick may be disabled, so depend on the controller (which processes input) directly
+    SetControllerTickPrerequisite(NewController);
+
+    // Whether the meshes are throttled depends on who is looking
+    UpdateMeshesForCameraMode(ActiveCameraMode != NULL && ActiveCameraMode->GetRig().bFirstPersonMeshes && !IsCameraRigBlending());
+}
+
+void AExplorerCharacter::UnPossessed()
+{
+    SetControllerTickPrerequisite(NULL);
+
+    Super::UnPossessed();
+
+    UpdateMeshesForCameraMode(ActiveCameraModeIsFirstPerson);
+}
+
+void AExplorerCharacter::AddControllerYawInput(float Val)
+{
+    // Scripted and AI controllers (e.g. the stress test's) have no rotation input processing of their own
+    if (Val != 0.f && Controller != NULL && !Controller->IsA(APlayerController::StaticClass()))
+    {
+        FRotator controlRotation = Controller->GetControlRotation();
+        controlRotation.Yaw = FRotator::ClampAxis(controlRotation.Yaw + Val);
+        Controller->SetControlRotation(controlRotation);
+        return;
+    }
+
+    Super::AddControllerYawInput(Val);
+}
+
+void AExplorerCharacter::AddControllerPitchInput(float Val)
+{
+    if (Val != 0.f && Controller != NULL && !Controller->IsA(APlayerController::StaticClass()))
+    {
+        FRotator controlRotation = Controller->GetControlRotation();
+        controlRotation.Pitch = FRotator::ClampAxis(controlRotation.Pitch + Val);
+        Controller->SetControlRotation(controlRotation);
+        return;
+    }
+
+    Super::AddControllerPitchInput(Val);
+}
+
+void AExplorerCharacter::PawnClientRestart()
+{
+    Super::PawnClientRestart();
+
+    // Clients only find out they are controlling this character here
+    SetControllerTickPrerequisite(Controller);
+    UpdateMeshesForCameraMode(ActiveCameraModeIsFirstPerson);
+}
+
+void AExplorerCharacter::OnRep_Controller()
+{
+    Super::OnRep_Controller();
+
+    // PossessedBy only runs on the server. Clients only replicate the owner's controller, so this is NULL elsewhere.
+    SetControllerTickPrerequisite(Controller);
+}
+
+void AExplorerCharacter::Tick(float DeltaSeconds)
+{
+    EXPLORER_SCOPE_CYCLE_COUNTER(Tick);
+
+    if (InputTraceReader.IsValid())
+    {
+        ApplyInputReplayFrame();
+    }
+
+    Super::Tick(DeltaSeconds);
+
+    if (InputTraceWriter.IsValid())
+    {
+        InputTraceWriter->EndFrame(DeltaSeconds);
+    }
+}
+
+void AExplorerCharacter::CalcCamera(float DeltaTime, FMinimalViewInfo& OutResult)
+{
+    // The camera components were posed when the boom ticked, which can be before this frame's look input was applied
+    Super::CalcCamera(DeltaTime, OutResult);
+
+    if (Controller == NULL || !IsLocallyControlled()) return;
+
+    const FRotator controlRotation = Controller->GetControlRotation();
+
+    const int32 lateUpdateOverride = ExplorerCharacter::CVarLateUpdate.GetValueOnGameThread();
+    const bool bLateUpdate = (lateUpdateOverride < 0) ? LateUpdateCameraRotation : (lateUpdateOverride != 0);
+    const FVector pivot = CameraBoom->GetComponentLocation() + CameraBoom->TargetOffset;
+    if (bLateUpdate && CameraBoom->bUseControllerViewRotation && !CameraBoom->bEnableCameraRotationLag)
+    {
+        // Swing the posed view around the boom's pivot by whatever rotation it has not picked up yet
+        const FQuat correction = FQuat(controlRotation) * FQuat(OutResult.Rotation).Inverse();
+        OutResult.Location = pivot + correction.RotateVector(OutResult.Location - pivot);
+        OutResult.Rotation = controlRotation;
+    }
+
+    LookLatency.NoteView(controlRotation, OutResult.Rotation);
+
+    if (FExplorerCameraTelemetry::IsEnabled())
+    {
+        CameraTelemetry.AddFrame(CameraModeEnum, OutResult.Location, OutResult.Rotation, DeltaTime);
+    }
+
+    FExplorerStreamingPrefetch::FView streamingView;
+    streamingView.Pivot = pivot;
+    streamingView.Location = OutResult.Location;
+    streamingView.Rotation = OutResult.Rotation;
+    streamingView.FOV = OutResult.FOV;
+    streamingView.bResetting = IsResetting;
+    streamingView.ResetTargetYaw = Mesh->GetTransformMatrix().Rotator().Yaw + FExplorerFollowCameraParams().MeshYawOffset;
+    streamingView.HorizonSeconds = ActiveCameraModeIsFirstPerson ? 0.f : GetCameraProfile().StreamingPrefetchSeconds;
+    StreamingPrefetch.NoteView(GetWorld(), streamingView, DeltaTime);
+
+    PublishCameraSnapshot(OutResult.Location, OutResult.Rotation);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+// Tick Scheduling
+#pragma mark - Tick Scheduling
+
+void FExplorerControllerTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if (Target != NULL && !Target->IsPendingKill() && TickType != LEVELTICK_ViewportsOnly)
+    {
+        // Only the camera work is throttled; movement input goes to a movement component that ticks every frame
+        float cameraDeltaTime = DeltaTime;
+        if (Interval > 0.f)
         {
-            float resetSpeed = (IsAutoReset) ? AutoResetSpeed : CameraResetSpeed;
-            AddControllerYawInput(delta * DeltaSeconds * resetSpeed);
+            SkippedSeconds += DeltaTime;
+            cameraDeltaTime = 0.f;
+            if (SkippedSeconds >= Interval)
+            {
+                cameraDeltaTime = SkippedSeconds;
+                SkippedSeconds = 0.f;
+            }
         }
 
-        return;
+        Target->TickController(DeltaTime, cameraDeltaTime);
+    }
+}
+
+FString FExplorerControllerTickFunction::DiagnosticMessage()
+{
+    return (Target != NULL) ? Target->GetFullName() + TEXT("[TickController]") : TEXT("<NULL>[TickController]");
+}
+
+void AExplorerCharacter::WakeControllerTick()
+{
+    if (ControllerTick.IsTickFunctionEnabled() || !ControllerTick.IsTickFunctionRegistered()) return;
+
+    ControllerTick.SkippedSeconds = 0.f;
+    ControllerTick.SetTickFunctionEnable(true);
+}
+
+void AExplorerCharacter::SleepControllerTick()
+{
+    if (ControllerTick.IsTickFunctionEnabled())
+    {
+        ControllerTick.SetTickFunctionEnable(false);
+    }
+}
+
+void AExplorerCharacter::UpdateControllerTickInterval()
+{
+    ControllerTick.Interval = FMath::Max(ControllerTickInterval, SignificanceTickInterval);
+}
+
+void AExplorerCharacter::SetSignificanceTickInterval(float Interval)
+{
+    // The primary tick is usually disabled, so less significant characters have their camera work throttled in the controller tick
+    SignificanceTickInterval = Interval;
+    UpdateControllerTickInterval();
+}
+
+void AExplorerCharacter::UpdatePrimaryTickEnabled()
+{
+    // Blueprint subclasses keep their primary tick, since it also drives ReceiveTick and latent actions
+    const bool bNeedsPrimaryTick = InputTraceWriter.IsValid() || InputTraceReader.IsValid() || Cast<UBlueprintGeneratedClass>(GetClass()) != NULL;
+    if (PrimaryActorTick.IsTickFunctionEnabled() != bNeedsPrimaryTick)
+    {
+        PrimaryActorTick.SetTickFunctionEnable(bNeedsPrimaryTick);
     }
+}
 
-    const FRotator YawRotation(0, Rotation.Yaw, 0);
-    float forwardAxis = GetInputAxisValue("MoveForward");
-    float rightAxis = GetInputAxisValue("MoveRight");
+void AExplorerCharacter::TickController(float DeltaSeconds, float CameraDeltaSeconds)
+{
+    EXPLORER_SCOPE_CYCLE_COUNTER(TickController);
 
-    float inputVectorLength = UKismetMathLibrary::FClamp((fabsf(forwardAxis) + fabsf(rightAxis)), 0.f, 1.f);
+    GatherMovementIntent();
 
-    if (inputVectorLength == 0.f) return;
+    if (MovementIntent.HasMovement())
+    {
+        if (MovementIntent.ForwardAxis != 0.f) AddMovementInput(MovementIntent.ForwardDirection, MovementIntent.ForwardAxis);
+        if (MovementIntent.RightAxis != 0.f) AddMovementInput(MovementIntent.RightDirection, MovementIntent.RightAxis);
+    }
 
-    const FVector forward = UKismetMathLibrary::GetForwardVector(YawRotation);
-    const FVector right = UKismetMathLibrary::GetRightVector(YawRotation);
+    // A throttled frame leaves the camera as it is, and counts as busy until an update finds out otherwise
+    if (CameraDeltaSeconds <= 0.f) return;
 
-    const FVector forwardVector = UKismetMathLibrary::Multiply_VectorFloat(forward, forwardAxis);
-    const FVector rightVector = UKismetMathLibrary::Multiply_VectorFloat(right, rightAxis);
+    // One indirect call into the active camera mode, and only for modes that have per-frame work
+    bool bCameraModeBusy = false;
+    if (ActiveCameraModeHasPerFrameWork)
+    {
+        bCameraModeBusy = ActiveCameraMode->Update(*this, CameraDeltaSeconds);
+    }
 
-    const FVector combinedVector = UKismetMathLibrary::Normal(forwardVector + rightVector);
+    if (IsCameraRigBlending())
+    {
+        bCameraModeBusy |= UpdateCameraRigBlend(CameraDeltaSeconds);
+    }
 
-    // 1 = character is perpindicular to camera vector, 0 when parallel to camera vector
-    float dotProduct = 1 - fabsf(UKismetMathLibrary::Dot_VectorVector(forwardVector, combinedVector));
-    dotProduct = UKismetMathLibrary::MultiplyMultiply_FloatFloat(dotProduct, CameraFollowTurnAngleExponent);
+    // Nothing to move and the camera is settled, so there is no work until the next input or reset wakes the tick up
+    if (!MovementIntent.HasMovement() && !bCameraModeBusy)
+    {
+        SleepControllerTick();
+    }
+}
 
-    FRotator combined = UKismetMathLibrary::Conv_VectorToRotator(combinedVector);
-    FRotator delta = UKismetMathLibrary::NormalizedDeltaRotator(combined, Rotation);
-    AddControllerYawInput(UKismetMathLibrary::FClamp(inputVectorLength * DeltaSeconds * dotProduct * CameraFollowTurnRate, 0.f, 1.f) * delta.Yaw);
+void AExplorerCharacter::GatherMovementIntent()
+{
+    MovementIntent.ForwardAxis = PendingForwardAxis;
+    MovementIntent.RightAxis = PendingRightAxis;
+    PendingForwardAxis = 0.f;
+    PendingRightAxis = 0.f;
 
+    if (!MovementIntent.HasMovement()) return;
+
+    if (IsInThirdPersonMode())
+    {
+        if (Controller == NULL)
+        {
+            MovementIntent.ForwardAxis = 0.f;
+            MovementIntent.RightAxis = 0.f;
+            return;
+        }
 
-}
\ No newline at end of file
+        // Camera relative, yaw only. Forward and right come from a single sin/cos of the control yaw.
+        float yawSin, yawCos;
+        FMath::SinCos(&yawSin, &yawCos, Controller->GetControlRotation().Yaw * (PI / 180.f));
+        MovementIntent.ForwardDirection = FVector(yawCos, yawSin, 0.f);
+        MovementIntent.RightDirection = FVector(-yawSin, yawCos, 0.f);
+    }
+    else
+    {
+        const FRotationMatrix actorMatrix(GetActorRotation());
+        MovementIntent.ForwardDirection = actorMatrix.GetUnitAxis(EAxis::X);
+        MovementIntent.RightDirection = actorMatrix.GetUnitAxis(EAxis::Y);
+    }
+}
@@ -0,0 +1,146 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerControllerTrace.h"
+#include "ExplorerCharacter.h"
+#include "Engine.h"
+
+#if EXPLORER_CONTROLLER_TRACE
+
+namespace ExplorerControllerTrace
+{
+    static_assert((FExplorerControllerTrace::Capacity & (FExplorerControllerTrace::Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    /** A ring buffer entry. Sequence is one more than the index of the record it holds, or zero while empty or being written. */
+    struct FSlot
+    {
+        volatile int32 Sequence;
+        FExplorerControllerTraceRecord Record;
+    };
+
+    static FSlot Slots[FExplorerControllerTrace::Capacity];
+
+    /** Total number of records ever claimed. The next record goes in slot WriteIndex % Capacity. */
+    static volatile int32 WriteIndex = 0;
+
+    static TAutoConsoleVariable<int32> CVarOnScreen(
+        TEXT("Explorer.Trace.OnScreen"),
+        0,
+        TEXT("Echo character controller events to the screen as they are recorded.\n")
+        TEXT("This formats a string per event, so leave it off when measuring."));
+
+    static TAutoConsoleVariable<int32> CVarLog(
+        TEXT("Explorer.Trace.Log"),
+        0,
+        TEXT("Echo character controller events to the log as they are recorded.\n")
+        TEXT("This formats a string per event, so leave it off when measuring."));
+
+    static FString FormatRecord(const FExplorerControllerTraceRecord& Record)
+    {
+        return FString::Printf(TEXT("[%llu] %s: %s (%s, %.2f)"),
+            Record.Frame,
+            *Record.ActorName.ToString(),
+            FExplorerControllerTrace::GetEventName((EExplorerControllerEvent::Type)Record.Event),
+            GetNameForCameraMode((ECharacterCameraMode::Type)Record.CameraMode),
+            Record.Value);
+    }
+
+    static void DumpTrace(const TArray<FString>& Args)
+    {
+        const int32 MaxRecords = (Args.Num() > 0) ? FCString::Atoi(*Args[0]) : FExplorerControllerTrace::Capacity;
+
+        TArray<FExplorerControllerTraceRecord> Records;
+        FExplorerControllerTrace::GetRecentRecords(Records, MaxRecords);
+
+        UE_LOG(LogExplorer, Log, TEXT("Controller trace: %d records"), Records.Num());
+        for (int32 Index = 0; Index < Records.Num(); Index++)
+        {
+            UE_LOG(LogExplorer, Log, TEXT("  %.4f %s"), Records[Index].Time, *FormatRecord(Records[Index]));
+        }
+    }
+
+    static FAutoConsoleCommand DumpTraceCommand(
+        TEXT("Explorer.DumpControllerTrace"),
+        TEXT("Writes the most recent character controller events to the log. Optional argument: number of events."),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&DumpTrace));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerControllerTrace
+#pragma mark - FExplorerControllerTrace
+
+void FExplorerControllerTrace::Record(const UObject* Source, EExplorerControllerEvent::Type Event, uint8 CameraMode, float Value)
+{
+    using namespace ExplorerControllerTrace;
+
+    const int32 Index = FPlatformAtomics::InterlockedIncrement(&WriteIndex) - 1;
+    FSlot& Slot = Slots[Index & (Capacity - 1)];
+
+    Slot.Sequence = 0;
+    FPlatformMisc::MemoryBarrier();
+
+    Slot.Record.Time = FPlatformTime::Seconds();
+    Slot.Record.Frame = GFrameCounter;
+    Slot.Record.ActorName = (Source != NULL) ? Source->GetFName() : NAME_None;
+    Slot.Record.Event = (uint8)Event;
+    Slot.Record.CameraMode = CameraMode;
+    Slot.Record.Value = Value;
+
+    FPlatformMisc::MemoryBarrier();
+    Slot.Sequence = Index + 1;
+
+    // Optional sinks. These allocate, which is why they are opt in.
+    const bool bOnScreen = IsInGameThread() && GEngine != NULL && CVarOnScreen.GetValueOnGameThread() != 0;
+    const bool bLog = CVarLog.GetValueOnAnyThread() != 0;
+    if (bOnScreen || bLog)
+    {
+        const FString Message = FormatRecord(Slot.Record);
+        if (bOnScreen) GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::White, Message);
+        if (bLog) UE_LOG(LogExplorer, Log, TEXT("%s"), *Message);
+    }
+}
+
+void FExplorerControllerTrace::GetRecentRecords(TArray<FExplorerControllerTraceRecord>& OutRecords, int32 MaxRecords)
+{
+    using namespace ExplorerControllerTrace;
+
+    OutRecords.Reset();
+
+    const int32 End = WriteIndex;
+    const int32 Count = FMath::Min(FMath::Min(MaxRecords, Capacity), End);
+    OutRecords.Reserve(Count);
+
+    for (int32 Index = End - Count; Index < End; Index++)
+    {
+        const FSlot& Slot = Slots[Index & (Capacity - 1)];
+        if (Slot.Sequence != Index + 1) continue;
+
+        FPlatformMisc::MemoryBarrier();
+        const FExplorerControllerTraceRecord Record = Slot.Record;
+        FPlatformMisc::MemoryBarrier();
+
+        // The slot was recycled while it was being copied
+        if (Slot.Sequence != Index + 1) continue;
+
+        OutRecords.Add(Record);
+    }
+}
+
+const TCHAR* FExplorerControllerTrace::GetEventName(EExplorerControllerEvent::Type Event)
+{
+    static const TCHAR* Names[] =
+    {
+        TEXT("Cycle Camera Requested"),
+        TEXT("Camera Mode Changed"),
+        TEXT("Reset Camera Requested"),
+        TEXT("Reset Finished"),
+        TEXT("Idle Timer Expired"),
+        TEXT("Zoom Camera In"),
+        TEXT("Zoom Camera Out"),
+    };
+    static_assert(ARRAY_COUNT(Names) == EExplorerControllerEvent::Max, "Missing controller event names");
+
+    return (Event < EExplorerControllerEvent::Max) ? Names[Event] : TEXT("Unknown Event");
+}
+
+#endif // EXPLORER_CONTROLLER_TRACE
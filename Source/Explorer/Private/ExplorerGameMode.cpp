@@ -3,14 +3,323 @@
 #include "Explorer.h"
 #include "ExplorerGameMode.h"
 #include "ExplorerCharacter.h"
+#include "ExplorerPlayerController.h"
+#include "Engine.h"
+
+namespace ExplorerGameMode
+{
+    /** When the current map started loading. Zero for the first map, which is timed from process start. */
+    static double MapLoadStartSeconds = 0.0;
+
+    static void OnPreLoadMap()
+    {
+        MapLoadStartSeconds = FPlatformTime::Seconds();
+    }
+
+    /** Spawn times for pawns taken from the pool, [0], and constructed from scratch, [1] */
+    struct FSpawnTimes
+    {
+        uint64 Count;
+        double TotalSeconds;
+        double MaxSeconds;
+    };
+    static FSpawnTimes SpawnTimes[2];
+
+    static uint64 NumPrewarmed = 0;
+    static uint64 NumRecycled = 0;
+    static uint64 NumDestroyed = 0;
+
+    static uint64 NumGarbageCollections = 0;
+    static double GarbageCollectionSeconds = 0.0;
+    static double MaxGarbageCollectionSeconds = 0.0;
+    static double GarbageCollectionStartSeconds = 0.0;
+
+    static void RecordSpawn(bool bPooled, double Seconds)
+    {
+        FSpawnTimes& times = SpawnTimes[bPooled ? 0 : 1];
+        times.Count++;
+        times.TotalSeconds += Seconds;
+        times.MaxSeconds = FMath::Max(times.MaxSeconds, Seconds);
+    }
+
+    static void OnPreGarbageCollect()
+    {
+        GarbageCollectionStartSeconds = FPlatformTime::Seconds();
+    }
+
+    static void OnPostGarbageCollect()
+    {
+        const double seconds = FPlatformTime::Seconds() - GarbageCollectionStartSeconds;
+        NumGarbageCollections++;
+        GarbageCollectionSeconds += seconds;
+        MaxGarbageCollectionSeconds = FMath::Max(MaxGarbageCollectionSeconds, seconds);
+    }
+
+    static void BindPreLoadMap()
+    {
+        static bool bBound = false;
+        if (!bBound)
+        {
+            bBound = true;
+            FCoreUObjectDelegates::PreLoadMap.AddStatic(&OnPreLoadMap);
+            FCoreUObjectDelegates::PreGarbageCollect.AddStatic(&OnPreGarbageCollect);
+            FCoreUObjectDelegates::PostGarbageCollect.AddStatic(&OnPostGarbageCollect);
+        }
+    }
+
+    static void DumpPool()
+    {
+        static const TCHAR* Labels[2] = { TEXT("from the pool"), TEXT("constructed") };
+        for (int32 Index = 0; Index < 2; Index++)
+        {
+            const FSpawnTimes& times = SpawnTimes[Index];
+            UE_LOG(LogExplorer, Log, TEXT("Pawns %s: %llu, avg %.3f ms, max %.3f ms"), Labels[Index], times.Count,
+                times.Count > 0 ? times.TotalSeconds * 1000.0 / times.Count : 0.0, times.MaxSeconds * 1000.0);
+        }
+        UE_LOG(LogExplorer, Log, TEXT("Pawn pool: %llu prewarmed, %llu recycled, %llu destroyed"), NumPrewarmed, NumRecycled, NumDestroyed);
+        UE_LOG(LogExplorer, Log, TEXT("Garbage collections: %llu, avg %.2f ms, max %.2f ms"), NumGarbageCollections,
+            NumGarbageCollections > 0 ? GarbageCollectionSeconds * 1000.0 / NumGarbageCollections : 0.0, MaxGarbageCollectionSeconds * 1000.0);
+    }
+
+    static void ResetPool()
+    {
+        FMemory::Memzero(SpawnTimes, sizeof(SpawnTimes));
+        NumPrewarmed = 0;
+        NumRecycled = 0;
+        NumDestroyed = 0;
+        NumGarbageCollections = 0;
+        GarbageCollectionSeconds = 0.0;
+        MaxGarbageCollectionSeconds = 0.0;
+    }
+
+    static FAutoConsoleCommand DumpPoolCommand(
+        TEXT("Explorer.Pool.Dump"),
+        TEXT("Writes pawn spawn times, pool use and garbage collection times to the log."),
+        FConsoleCommandDelegate::CreateStatic(&DumpPool));
+
+    static FAutoConsoleCommand ResetPoolCommand(
+        TEXT("Explorer.Pool.Reset"),
+        TEXT("Clears the pawn spawn and garbage collection measurements."),
+        FConsoleCommandDelegate::CreateStatic(&ResetPool));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// AExplorerGameMode
+#pragma mark AExplorerGameMode
 
 AExplorerGameMode::AExplorerGameMode(const class FPostConstructInitializeProperties& PCIP)
 	: Super(PCIP)
 {
-	// set default pawn class to our Blueprinted character
-	static ConstructorHelpers::FClassFinder<APawn> PlayerPawnBPClass(TEXT("/Game/Blueprints/MyCharacter"));
-	if (PlayerPawnBPClass.Class != NULL)
-	{
-		DefaultPawnClass = PlayerPawnBPClass.Class;
-	}
+	// Our Blueprinted character, loaded asynchronously in InitGame
+    PlayerPawnClass = TAssetSubclassOf<APawn>(FStringAssetReference(TEXT("/Game/Blueprints/MyCharacter.MyCharacter_C")));
+    DefaultPawnClass = AExplorerCharacter::StaticClass();
+    PlayerControllerClass = AExplorerPlayerController::StaticClass();
+
+    PrimaryActorTick.bCanEverTick = true;
+
+    PawnPoolSize = 4;
+    StartedPlay = false;
+
+    PawnClassLoaded = false;
+    InitGameSeconds = 0.0;
+    PawnClassLoadedSeconds = 0.0;
+    PlayerSpawnedSeconds = 0.0;
+    ReportedStartupTime = false;
+}
+
+void AExplorerGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+    ExplorerGameMode::BindPreLoadMap();
+    InitGameSeconds = FPlatformTime::Seconds();
+
+    Super::InitGame(MapName, Options, ErrorMessage);
+
+    if (PlayerPawnClass.IsNull() || PlayerPawnClass.Get() != NULL)
+    {
+        OnPawnClassLoaded();
+        return;
+    }
+
+    Streamable.RequestAsyncLoad(PlayerPawnClass.ToStringReference(),
+        FStreamableDelegate::CreateUObject(this, &AExplorerGameMode::OnPawnClassLoaded));
+}
+
+void AExplorerGameMode::OnPawnClassLoaded()
+{
+    if (PawnClassLoaded) return;
+
+    PawnClassLoaded = true;
+    PawnClassLoadedSeconds = FPlatformTime::Seconds();
+
+    UClass* pawnClass = PlayerPawnClass.Get();
+    if (pawnClass != NULL)
+    {
+        DefaultPawnClass = pawnClass;
+    }
+    else if (!PlayerPawnClass.IsNull())
+    {
+        UE_LOG(LogExplorer, Warning, TEXT("Could not load %s, players get %s instead"), *PlayerPawnClass.ToStringReference().ToString(), *DefaultPawnClass->GetName());
+    }
+
+    // Before play starts, StartPlay fills the pool
+    if (StartedPlay)
+    {
+        PrewarmPawnPool();
+    }
+
+    for (int32 Index = 0; Index < PendingRestarts.Num(); Index++)
+    {
+        AController* controller = PendingRestarts[Index];
+        if (controller != NULL && !controller->IsPendingKill() && controller->GetPawn() == NULL)
+        {
+            RestartPlayer(controller);
+        }
+    }
+    PendingRestarts.Empty();
+}
+
+void AExplorerGameMode::StartPlay()
+{
+    // Filled before the players are started, so that they are the first to be handed pooled characters
+    StartedPlay = true;
+    if (PawnClassLoaded)
+    {
+        PrewarmPawnPool();
+    }
+
+    Super::StartPlay();
+}
+
+void AExplorerGameMode::PrewarmPawnPool()
+{
+    if (DefaultPawnClass == NULL || !DefaultPawnClass->IsChildOf(AExplorerCharacter::StaticClass())) return;
+
+    const double startSeconds = FPlatformTime::Seconds();
+    const int32 numBefore = PooledPawns.Num();
+
+    FActorSpawnParameters spawnParameters;
+    spawnParameters.bNoCollisionFail = true;
+    while (PooledPawns.Num() < PawnPoolSize)
+    {
+        AExplorerCharacter* character = GetWorld()->SpawnActor<AExplorerCharacter>(DefaultPawnClass, FVector::ZeroVector, FRotator::ZeroRotator, spawnParameters);
+        if (character == NULL) break;
+
+        character->EnterPawnPool();
+        PooledPawns.Add(character);
+    }
+
+    const int32 numSpawned = PooledPawns.Num() - numBefore;
+    if (numSpawned > 0)
+    {
+        ExplorerGameMode::NumPrewarmed += numSpawned;
+        UE_LOG(LogExplorer, Log, TEXT("Prewarmed %d %s in %.2f ms"), numSpawned, *DefaultPawnClass->GetName(), (FPlatformTime::Seconds() - startSeconds) * 1000.0);
+    }
+}
+
+APawn* AExplorerGameMode::SpawnDefaultPawnFor(AController* NewPlayer, AActor* StartSpot)
+{
+    const double startSeconds = FPlatformTime::Seconds();
+
+    // Characters left over from a pawn class that has since changed are not handed out
+    AExplorerCharacter* character = NULL;
+    while (character == NULL && PooledPawns.Num() > 0)
+    {
+        AExplorerCharacter* candidate = PooledPawns.Pop(false);
+        if (candidate == NULL || candidate->IsPendingKill()) continue;
+
+        if (candidate->GetClass() != DefaultPawnClass)
+        {
+            candidate->Destroy();
+            ExplorerGameMode::NumDestroyed++;
+            continue;
+        }
+        character = candidate;
+    }
+
+    if (character == NULL)
+    {
+        APawn* pawn = Super::SpawnDefaultPawnFor(NewPlayer, StartSpot);
+        ExplorerGameMode::RecordSpawn(false, FPlatformTime::Seconds() - startSeconds);
+        return pawn;
+    }
+
+    // Placed the way the base class places a new pawn
+    const FRotator startRotation(0.f, StartSpot->GetActorRotation().Yaw, 0.f);
+    character->LeavePawnPool(StartSpot->GetActorLocation(), startRotation);
+    character->Instigator = Instigator;
+
+    ExplorerGameMode::RecordSpawn(true, FPlatformTime::Seconds() - startSeconds);
+    return character;
+}
+
+void AExplorerGameMode::ReleasePawn(APawn* Pawn)
+{
+    if (Pawn == NULL || Pawn->IsPendingKill()) return;
+
+    if (Pawn->Controller != NULL)
+    {
+        Pawn->Controller->UnPossess();
+    }
+
+    AExplorerCharacter* character = Cast<AExplorerCharacter>(Pawn);
+    if (character == NULL || character->GetClass() != DefaultPawnClass || PooledPawns.Num() >= PawnPoolSize)
+    {
+        Pawn->Destroy();
+        ExplorerGameMode::NumDestroyed++;
+        return;
+    }
+
+    character->EnterPawnPool();
+    PooledPawns.Add(character);
+    ExplorerGameMode::NumRecycled++;
+}
+
+void AExplorerGameMode::RespawnPlayer(AController* Player)
+{
+    if (Player == NULL) return;
+
+    ReleasePawn(Player->GetPawn());
+    RestartPlayer(Player);
+}
+
+void AExplorerGameMode::RestartPlayer(AController* NewPlayer)
+{
+    // Players that arrive before the pawn class wait as spectators until it has loaded
+    if (!PawnClassLoaded)
+    {
+        PendingRestarts.AddUnique(NewPlayer);
+        return;
+    }
+
+    Super::RestartPlayer(NewPlayer);
+
+    APlayerController* playerController = Cast<APlayerController>(NewPlayer);
+    if (PlayerSpawnedSeconds == 0.0 && playerController != NULL && playerController->IsLocalController() && playerController->GetPawn() != NULL)
+    {
+        PlayerSpawnedSeconds = FPlatformTime::Seconds();
+    }
+}
+
+void AExplorerGameMode::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    // The first frame after the spawn is the first one the player has control in
+    if (!ReportedStartupTime && PlayerSpawnedSeconds != 0.0)
+    {
+        ReportedStartupTime = true;
+        ReportStartupTime();
+    }
+}
+
+void AExplorerGameMode::ReportStartupTime()
+{
+    const double now = FPlatformTime::Seconds();
+    const bool bMapTravel = ExplorerGameMode::MapLoadStartSeconds != 0.0;
+    const double startSeconds = bMapTravel ? ExplorerGameMode::MapLoadStartSeconds : GStartTime;
+
+    UE_LOG(LogExplorer, Log, TEXT("First controllable frame %.3f s after %s (map load %.3f s, pawn class %.3f s, spawn %.3f s, first frame %.3f s)"),
+        now - startSeconds, bMapTravel ? TEXT("map travel started") : TEXT("process start"),
+        InitGameSeconds - startSeconds, PawnClassLoadedSeconds - InitGameSeconds,
+        PlayerSpawnedSeconds - FMath::Max(PawnClassLoadedSeconds, InitGameSeconds), now - PlayerSpawnedSeconds);
 }
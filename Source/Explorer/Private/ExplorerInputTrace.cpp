@@ -0,0 +1,346 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerInputTrace.h"
+
+#if PLATFORM_WINDOWS
+#include "AllowWindowsPlatformTypes.h"
+#include <windows.h>
+#include "HideWindowsPlatformTypes.h"
+#elif PLATFORM_LINUX || PLATFORM_MAC
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define EXPLORER_POSIX_MMAP 1
+#endif
+
+#ifndef EXPLORER_POSIX_MMAP
+#define EXPLORER_POSIX_MMAP 0
+#endif
+
+namespace ExplorerInputTrace
+{
+    static const uint32 Magic = 'E' | ('X' << 8) | ('T' << 16) | ('R' << 24);
+    static const uint16 Version = 1;
+
+    /** Size of the fixed part of a frame record (delta, axis mask, action mask) */
+    static const int64 FrameHeaderSize = sizeof(float) + 2 * sizeof(uint8);
+
+    /** Buffered frames are written out once this much is pending */
+    static const int32 FlushThreshold = 64 * 1024;
+
+    template<typename T>
+    static void Append(TArray<uint8>& Buffer, const T& Value)
+    {
+        const int32 Index = Buffer.AddUninitialized(sizeof(T));
+        FMemory::Memcpy(Buffer.GetData() + Index, &Value, sizeof(T));
+    }
+
+    template<typename T>
+    static T Read(const uint8* Data)
+    {
+        T Value;
+        FMemory::Memcpy(&Value, Data, sizeof(T));
+        return Value;
+    }
+
+    static void AppendVector(TArray<uint8>& Buffer, float X, float Y, float Z)
+    {
+        Append(Buffer, X);
+        Append(Buffer, Y);
+        Append(Buffer, Z);
+    }
+
+    static uint32 CountBits(uint8 Mask)
+    {
+        uint32 Count = 0;
+        for (; Mask; Mask &= Mask - 1) Count++;
+        return Count;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerInputTraceWriter
+#pragma mark - FExplorerInputTraceWriter
+
+FExplorerInputTraceWriter::FExplorerInputTraceWriter(const FString& InFilename, FArchive* InArchive)
+    : Filename(InFilename)
+    , Archive(InArchive)
+    , NumFrames(0)
+{
+    Buffer.Reserve(ExplorerInputTrace::FlushThreshold * 2);
+}
+
+FExplorerInputTraceWriter::~FExplorerInputTraceWriter()
+{
+    Close();
+}
+
+TSharedPtr<FExplorerInputTraceWriter> FExplorerInputTraceWriter::Create(const FString& Filename, const FExplorerInputTraceHeader& Header)
+{
+    FArchive* Archive = IFileManager::Get().CreateFileWriter(*Filename);
+    if (Archive == NULL)
+    {
+        UE_LOG(LogExplorer, Warning, TEXT("Could not create input trace %s"), *Filename);
+        return TSharedPtr<FExplorerInputTraceWriter>();
+    }
+
+    TSharedPtr<FExplorerInputTraceWriter> Writer = MakeShareable(new FExplorerInputTraceWriter(Filename, Archive));
+
+    using namespace ExplorerInputTrace;
+    TArray<uint8>& Buffer = Writer->Buffer;
+    Append(Buffer, Magic);
+    Append(Buffer, Version);
+    const int32 HeaderSizeIndex = Buffer.Num();
+    Append(Buffer, (uint16)0);
+    Append(Buffer, Header.StartTicks);
+    AppendVector(Buffer, Header.Location.X, Header.Location.Y, Header.Location.Z);
+    AppendVector(Buffer, Header.Rotation.Pitch, Header.Rotation.Yaw, Header.Rotation.Roll);
+    AppendVector(Buffer, Header.ControlRotation.Pitch, Header.ControlRotation.Yaw, Header.ControlRotation.Roll);
+    Append(Buffer, Header.CameraZoom);
+    Append(Buffer, Header.CameraMode);
+
+    const uint16 HeaderSize = (uint16)Buffer.Num();
+    FMemory::Memcpy(Buffer.GetData() + HeaderSizeIndex, &HeaderSize, sizeof(HeaderSize));
+
+    return Writer;
+}
+
+void FExplorerInputTraceWriter::EndFrame(float DeltaSeconds)
+{
+    if (Archive == NULL) return;
+
+    using namespace ExplorerInputTrace;
+
+    uint8 AxisMask = 0;
+    for (int32 Axis = 0; Axis < EExplorerInputTraceAxis::Max; Axis++)
+    {
+        if (CurrentFrame.Axes[Axis] != 0.f) AxisMask |= (1 << Axis);
+    }
+
+    Append(Buffer, DeltaSeconds);
+    Append(Buffer, AxisMask);
+    Append(Buffer, CurrentFrame.ActionMask);
+    for (int32 Axis = 0; Axis < EExplorerInputTraceAxis::Max; Axis++)
+    {
+        if (AxisMask & (1 << Axis)) Append(Buffer, CurrentFrame.Axes[Axis]);
+    }
+
+    NumFrames++;
+    CurrentFrame.Reset();
+
+    if (Buffer.Num() >= FlushThreshold) Flush();
+}
+
+void FExplorerInputTraceWriter::Flush()
+{
+    if (Archive != NULL && Buffer.Num() > 0)
+    {
+        Archive->Serialize(Buffer.GetData(), Buffer.Num());
+    }
+    Buffer.Reset();
+}
+
+void FExplorerInputTraceWriter::Close()
+{
+    if (Archive == NULL) return;
+
+    Flush();
+    Archive->Close();
+    delete Archive;
+    Archive = NULL;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerInputTraceReader
+#pragma mark - FExplorerInputTraceReader
+
+FExplorerInputTraceReader::FExplorerInputTraceReader(const FString& InFilename)
+    : Filename(InFilename)
+    , Data(NULL)
+    , Size(0)
+    , Offset(0)
+    , NumFramesRead(0)
+    , FileHandle(NULL)
+    , MappingHandle(NULL)
+{
+}
+
+FExplorerInputTraceReader::~FExplorerInputTraceReader()
+{
+    Unmap();
+}
+
+TSharedPtr<FExplorerInputTraceReader> FExplorerInputTraceReader::Open(const FString& Filename)
+{
+    TSharedPtr<FExplorerInputTraceReader> Reader = MakeShareable(new FExplorerInputTraceReader(Filename));
+    if (!Reader->Map())
+    {
+        UE_LOG(LogExplorer, Warning, TEXT("Could not open input trace %s"), *Filename);
+        return TSharedPtr<FExplorerInputTraceReader>();
+    }
+
+    using namespace ExplorerInputTrace;
+
+    const int64 MinimumHeaderSize = sizeof(uint32) + 2 * sizeof(uint16);
+    if (Reader->Size < MinimumHeaderSize || Read<uint32>(Reader->Data) != Magic || Read<uint16>(Reader->Data + 4) != Version)
+    {
+        UE_LOG(LogExplorer, Warning, TEXT("%s is not a version %d input trace"), *Filename, Version);
+        return TSharedPtr<FExplorerInputTraceReader>();
+    }
+
+    const uint16 HeaderSize = Read<uint16>(Reader->Data + 6);
+    const int64 ExpectedHeaderSize = MinimumHeaderSize + sizeof(int64) + 10 * sizeof(float) + sizeof(uint8);
+    if (HeaderSize < ExpectedHeaderSize || HeaderSize > Reader->Size)
+    {
+        UE_LOG(LogExplorer, Warning, TEXT("Input trace %s has a truncated header"), *Filename);
+        return TSharedPtr<FExplorerInputTraceReader>();
+    }
+
+    const uint8* Cursor = Reader->Data + MinimumHeaderSize;
+    FExplorerInputTraceHeader& Header = Reader->Header;
+    Header.StartTicks = Read<int64>(Cursor);                 Cursor += sizeof(int64);
+    Header.Location.X = Read<float>(Cursor);                 Cursor += sizeof(float);
+    Header.Location.Y = Read<float>(Cursor);                 Cursor += sizeof(float);
+    Header.Location.Z = Read<float>(Cursor);                 Cursor += sizeof(float);
+    Header.Rotation.Pitch = Read<float>(Cursor);             Cursor += sizeof(float);
+    Header.Rotation.Yaw = Read<float>(Cursor);               Cursor += sizeof(float);
+    Header.Rotation.Roll = Read<float>(Cursor);              Cursor += sizeof(float);
+    Header.ControlRotation.Pitch = Read<float>(Cursor);      Cursor += sizeof(float);
+    Header.ControlRotation.Yaw = Read<float>(Cursor);        Cursor += sizeof(float);
+    Header.ControlRotation.Roll = Read<float>(Cursor);       Cursor += sizeof(float);
+    Header.CameraZoom = Read<float>(Cursor);                 Cursor += sizeof(float);
+    Header.CameraMode = Read<uint8>(Cursor);
+
+    Reader->Offset = HeaderSize;
+    return Reader;
+}
+
+bool FExplorerInputTraceReader::ReadFrame(FExplorerInputTraceFrame& OutFrame)
+{
+    const int64 NextOffset = DecodeFrame(Offset, OutFrame);
+    if (NextOffset < 0) return false;
+
+    Offset = NextOffset;
+    NumFramesRead++;
+    return true;
+}
+
+bool FExplorerInputTraceReader::PeekFrame(FExplorerInputTraceFrame& OutFrame) const
+{
+    return DecodeFrame(Offset, OutFrame) >= 0;
+}
+
+int64 FExplorerInputTraceReader::DecodeFrame(int64 FrameOffset, FExplorerInputTraceFrame& OutFrame) const
+{
+    using namespace ExplorerInputTrace;
+
+    if (FrameOffset + FrameHeaderSize > Size) return -1;
+
+    const uint8* Cursor = Data + FrameOffset;
+    const float DeltaSeconds = Read<float>(Cursor);
+    const uint8 AxisMask = Read<uint8>(Cursor + sizeof(float));
+    const uint8 ActionMask = Read<uint8>(Cursor + sizeof(float) + 1);
+
+    const int64 FrameSize = FrameHeaderSize + CountBits(AxisMask) * sizeof(float);
+    if (FrameOffset + FrameSize > Size) return -1;
+
+    OutFrame.Reset();
+    OutFrame.DeltaSeconds = DeltaSeconds;
+    OutFrame.ActionMask = ActionMask;
+
+    Cursor += FrameHeaderSize;
+    for (int32 Axis = 0; Axis < EExplorerInputTraceAxis::Max; Axis++)
+    {
+        if (AxisMask & (1 << Axis))
+        {
+            OutFrame.Axes[Axis] = Read<float>(Cursor);
+            Cursor += sizeof(float);
+        }
+    }
+
+    return FrameOffset + FrameSize;
+}
+
+bool FExplorerInputTraceReader::Map()
+{
+    const FString FullPath = FPaths::ConvertRelativePathToFull(Filename);
+
+#if PLATFORM_WINDOWS
+    HANDLE File = CreateFileW(*FullPath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (File == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER FileSize;
+    if (!GetFileSizeEx(File, &FileSize) || FileSize.QuadPart == 0)
+    {
+        CloseHandle(File);
+        return false;
+    }
+
+    HANDLE Mapping = CreateFileMappingW(File, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (Mapping == NULL)
+    {
+        CloseHandle(File);
+        return false;
+    }
+
+    Data = (const uint8*)MapViewOfFile(Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (Data == NULL)
+    {
+        CloseHandle(Mapping);
+        CloseHandle(File);
+        return false;
+    }
+
+    FileHandle = File;
+    MappingHandle = Mapping;
+    Size = FileSize.QuadPart;
+    return true;
+#elif EXPLORER_POSIX_MMAP
+    const int File = open(TCHAR_TO_UTF8(*FullPath), O_RDONLY);
+    if (File < 0) return false;
+
+    struct stat FileStat;
+    if (fstat(File, &FileStat) != 0 || FileStat.st_size == 0)
+    {
+        close(File);
+        return false;
+    }
+
+    void* Mapped = mmap(NULL, FileStat.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+    close(File);
+    if (Mapped == MAP_FAILED) return false;
+
+    madvise(Mapped, FileStat.st_size, MADV_SEQUENTIAL);
+    Data = (const uint8*)Mapped;
+    Size = FileStat.st_size;
+    return true;
+#else
+    if (!FFileHelper::LoadFileToArray(FallbackData, *FullPath)) return false;
+
+    Data = FallbackData.GetData();
+    Size = FallbackData.Num();
+    return Size > 0;
+#endif
+}
+
+void FExplorerInputTraceReader::Unmap()
+{
+    if (Data == NULL) return;
+
+#if PLATFORM_WINDOWS
+    UnmapViewOfFile(Data);
+    CloseHandle((HANDLE)MappingHandle);
+    CloseHandle((HANDLE)FileHandle);
+#elif EXPLORER_POSIX_MMAP
+    munmap((void*)Data, Size);
+#else
+    FallbackData.Empty();
+#endif
+
+    Data = NULL;
+    Size = 0;
+    FileHandle = NULL;
+    MappingHandle = NULL;
+}
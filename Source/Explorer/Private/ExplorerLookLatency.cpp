@@ -0,0 +1,117 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerLookLatency.h"
+#include "ExplorerStats.h"
+
+namespace ExplorerLookLatency
+{
+    /** How close a view has to be to a recorded control rotation to count as showing it, in degrees */
+    static const float RotationTolerance = .01f;
+
+    static uint64 NumMeasured = 0;
+    static double TotalSeconds = 0.0;
+    static double MaxSeconds = 0.0;
+    static uint64 TotalFrames = 0;
+    static uint64 NumSameFrame = 0;
+
+    static void Record(double Seconds, uint64 Frames)
+    {
+        NumMeasured++;
+        TotalSeconds += Seconds;
+        MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+        TotalFrames += Frames;
+        if (Frames == 0) NumSameFrame++;
+
+        SET_FLOAT_STAT(STAT_ExplorerLookLatency, (float)(Seconds * 1000.0));
+    }
+
+    static FAutoConsoleCommand DumpCommand(
+        TEXT("Explorer.Latency.Dump"),
+        TEXT("Writes the measured look input to view latency to the log."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerLookLatency::Dump));
+
+    static FAutoConsoleCommand ResetCommand(
+        TEXT("Explorer.Latency.Reset"),
+        TEXT("Clears the look input latency measurements."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerLookLatency::Reset));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerLookLatency
+#pragma mark FExplorerLookLatency
+
+FExplorerLookLatency::FExplorerLookLatency()
+    : NumSamples(0)
+    , PendingInputSeconds(0.0)
+{
+}
+
+void FExplorerLookLatency::NoteView(const FRotator& ControlRotation, const FRotator& ViewRotation)
+{
+    using namespace ExplorerLookLatency;
+
+    if (PendingInputSeconds != 0.0)
+    {
+        if (NumSamples == MaxSamples)
+        {
+            FMemory::Memmove(&Samples[0], &Samples[1], sizeof(FSample) * (MaxSamples - 1));
+            NumSamples--;
+        }
+
+        FSample& sample = Samples[NumSamples++];
+        sample.InputSeconds = PendingInputSeconds;
+        sample.InputFrame = GFrameCounter;
+        sample.ControlRotation = ControlRotation;
+        PendingInputSeconds = 0.0;
+    }
+
+    // The newest sample the view shows; everything before it has been superseded, so it was consumed too
+    int32 consumed = -1;
+    for (int32 Index = NumSamples - 1; Index >= 0; Index--)
+    {
+        if (Samples[Index].ControlRotation.Equals(ViewRotation, RotationTolerance))
+        {
+            consumed = Index;
+            break;
+        }
+    }
+    if (consumed < 0) return;
+
+    const double now = FPlatformTime::Seconds();
+    for (int32 Index = 0; Index <= consumed; Index++)
+    {
+        Record(now - Samples[Index].InputSeconds, GFrameCounter - Samples[Index].InputFrame);
+    }
+
+    NumSamples -= consumed + 1;
+    if (NumSamples > 0)
+    {
+        FMemory::Memmove(&Samples[0], &Samples[consumed + 1], sizeof(FSample) * NumSamples);
+    }
+}
+
+void FExplorerLookLatency::Dump()
+{
+    using namespace ExplorerLookLatency;
+
+    if (NumMeasured == 0)
+    {
+        UE_LOG(LogExplorer, Log, TEXT("Look input latency: nothing measured yet"));
+        return;
+    }
+
+    UE_LOG(LogExplorer, Log, TEXT("Look input latency: %llu inputs, avg %.2f ms, max %.2f ms, avg %.2f frames, %.0f%% shown the same frame"),
+        NumMeasured, TotalSeconds * 1000.0 / NumMeasured, MaxSeconds * 1000.0, (double)TotalFrames / NumMeasured, 100.0 * NumSameFrame / NumMeasured);
+}
+
+void FExplorerLookLatency::Reset()
+{
+    using namespace ExplorerLookLatency;
+
+    NumMeasured = 0;
+    TotalSeconds = 0.0;
+    MaxSeconds = 0.0;
+    TotalFrames = 0;
+    NumSameFrame = 0;
+}
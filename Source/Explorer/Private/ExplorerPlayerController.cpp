@@ -0,0 +1,50 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerPlayerController.h"
+#include "ExplorerPlayerInput.h"
+#include "ExplorerGameMode.h"
+
+//////////////////////////////////////////////////////////////////////////
+// AExplorerPlayerController
+#pragma mark AExplorerPlayerController
+
+AExplorerPlayerController::AExplorerPlayerController(const class FPostConstructInitializeProperties& PCIP)
+    : Super(PCIP)
+{
+}
+
+void AExplorerPlayerController::InitInputSystem()
+{
+    if (PlayerInput == NULL)
+    {
+        PlayerInput = ConstructObject<UExplorerPlayerInput>(UExplorerPlayerInput::StaticClass(), this);
+    }
+
+    Super::InitInputSystem();
+}
+
+void AExplorerPlayerController::PawnLeavingGame()
+{
+    AExplorerGameMode* gameMode = Cast<AExplorerGameMode>(GetWorld()->GetAuthGameMode());
+    if (gameMode == NULL || GetPawn() == NULL)
+    {
+        Super::PawnLeavingGame();
+        return;
+    }
+
+    gameMode->ReleasePawn(GetPawn());
+    SetPawn(NULL);
+}
+
+void AExplorerPlayerController::Respawn()
+{
+    AExplorerGameMode* gameMode = Cast<AExplorerGameMode>(GetWorld()->GetAuthGameMode());
+    if (gameMode == NULL)
+    {
+        UE_LOG(LogExplorer, Warning, TEXT("Respawn only works where the Explorer game mode runs"));
+        return;
+    }
+
+    gameMode->RespawnPlayer(this);
+}
@@ -0,0 +1,175 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerPlayerInput.h"
+
+const double FExplorerAxisIntegrator::MinEventSpreadSeconds = .001;
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerAxisIntegrator
+#pragma mark FExplorerAxisIntegrator
+
+FExplorerAxisIntegrator::FExplorerAxisIntegrator()
+{
+    Reset(NAME_None);
+}
+
+void FExplorerAxisIntegrator::Reset(FName InAxisName)
+{
+    AxisName = InAxisName;
+    NumKeys = 0;
+    HeldValue = 0.f;
+    ValueBeforeEvents = 0.f;
+    FirstEventSeconds = 0.0;
+    LastEventSeconds = 0.0;
+    Accumulated = 0.0;
+    bSampled = false;
+}
+
+void FExplorerAxisIntegrator::AddKey(FKey Key, float Scale)
+{
+    if (NumKeys == MaxKeys) return;
+
+    Keys[NumKeys] = Key;
+    Scales[NumKeys] = Scale;
+    Values[NumKeys] = 0.f;
+    NumKeys++;
+}
+
+bool FExplorerAxisIntegrator::SetKeyValue(FKey Key, float Value, double Seconds)
+{
+    bool bMapped = false;
+    for (int32 Index = 0; Index < NumKeys; Index++)
+    {
+        if (Keys[Index] != Key) continue;
+
+        Values[Index] = Value * Scales[Index];
+        bMapped = true;
+    }
+    if (!bMapped) return false;
+
+    // The previous value held from the previous event this frame. What it held before the first one is worked out
+    // in Consume, once the frame time is known.
+    if (bSampled)
+    {
+        Accumulated += HeldValue * (Seconds - LastEventSeconds);
+    }
+    else
+    {
+        ValueBeforeEvents = HeldValue;
+        FirstEventSeconds = Seconds;
+    }
+    LastEventSeconds = Seconds;
+
+    HeldValue = 0.f;
+    for (int32 Index = 0; Index < NumKeys; Index++)
+    {
+        HeldValue += Values[Index];
+    }
+    bSampled = true;
+    return true;
+}
+
+bool FExplorerAxisIntegrator::Consume(float FrameValue, float DeltaSeconds, double Seconds, float& OutValueSeconds)
+{
+    const bool bIntegrated = bSampled && LastEventSeconds - FirstEventSeconds >= MinEventSpreadSeconds;
+    if (bIntegrated)
+    {
+        // The value before the first event covers whatever part of the frame the events do not, and the newest value
+        // holds up to now, so the frame is covered exactly once
+        const double beforeSeconds = FMath::Max(DeltaSeconds - (Seconds - FirstEventSeconds), 0.0);
+        OutValueSeconds = (float)(ValueBeforeEvents * beforeSeconds + Accumulated + HeldValue * (Seconds - LastEventSeconds));
+    }
+
+    if (FrameValue == 0.f && !bSampled && HeldValue != 0.f)
+    {
+        HeldValue = 0.f;
+        FMemory::Memzero(Values, sizeof(Values));
+    }
+
+    Accumulated = 0.0;
+    bSampled = false;
+    return bIntegrated;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UExplorerPlayerInput
+#pragma mark - UExplorerPlayerInput
+
+UExplorerPlayerInput::UExplorerPlayerInput(const class FPostConstructInitializeProperties& PCIP)
+    : Super(PCIP)
+{
+    IntegratedAxes.Add(TEXT("TurnRate"));
+    IntegratedAxes.Add(TEXT("LookUpRate"));
+
+    IntegratedMappingCount = INDEX_NONE;
+}
+
+bool UExplorerPlayerInput::ConsumeIntegratedAxis(FName AxisName, float FrameValue, float DeltaSeconds, float& OutValueSeconds)
+{
+    RefreshIntegrators();
+
+    for (int32 Index = 0; Index < Integrators.Num(); Index++)
+    {
+        if (Integrators[Index].AxisName == AxisName)
+        {
+            return Integrators[Index].Consume(FrameValue, DeltaSeconds, FPlatformTime::Seconds(), OutValueSeconds);
+        }
+    }
+    return false;
+}
+
+bool UExplorerPlayerInput::InputKey(FKey Key, enum EInputEvent Event, float AmountDepressed, bool bGamepad)
+{
+    // Digital keys on a rate axis (the arrow keys) count as 1 while down
+    if (Event == IE_Pressed || Event == IE_Released)
+    {
+        SetIntegratedKeyValue(Key, (Event == IE_Pressed) ? AmountDepressed : 0.f);
+    }
+
+    return Super::InputKey(Key, Event, AmountDepressed, bGamepad);
+}
+
+bool UExplorerPlayerInput::InputAxis(FKey Key, float Delta, float DeltaTime, int32 NumSamples, bool bGamepad)
+{
+    // Analog sticks report their position, which goes through the same dead zone and sensitivity as the bindings see
+    if (bGamepad)
+    {
+        SetIntegratedKeyValue(Key, MassageAxisInput(Key, Delta));
+    }
+
+    return Super::InputAxis(Key, Delta, DeltaTime, NumSamples, bGamepad);
+}
+
+void UExplorerPlayerInput::SetIntegratedKeyValue(FKey Key, float Value)
+{
+    RefreshIntegrators();
+
+    const double seconds = FPlatformTime::Seconds();
+    for (int32 Index = 0; Index < Integrators.Num(); Index++)
+    {
+        Integrators[Index].SetKeyValue(Key, Value, seconds);
+    }
+}
+
+void UExplorerPlayerInput::RefreshIntegrators()
+{
+    if (IntegratedMappingCount == AxisMappings.Num() && Integrators.Num() == IntegratedAxes.Num()) return;
+    IntegratedMappingCount = AxisMappings.Num();
+
+    Integrators.SetNum(IntegratedAxes.Num());
+    for (int32 Index = 0; Index < IntegratedAxes.Num(); Index++)
+    {
+        FExplorerAxisIntegrator& integrator = Integrators[Index];
+        integrator.Reset(IntegratedAxes[Index]);
+
+        for (int32 MappingIndex = 0; MappingIndex < AxisMappings.Num(); MappingIndex++)
+        {
+            const FInputAxisKeyMapping& mapping = AxisMappings[MappingIndex];
+            if (mapping.AxisName == integrator.AxisName)
+            {
+                integrator.AddKey(mapping.Key, mapping.Scale);
+            }
+        }
+    }
+}
@@ -0,0 +1,244 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerSignificance.h"
+#include "ExplorerCharacter.h"
+#include "ExplorerStats.h"
+#include "Engine.h"
+
+namespace ExplorerSignificance
+{
+    static TAutoConsoleVariable<int32> CVarEnable(
+        TEXT("Explorer.Significance.Enable"),
+        1,
+        TEXT("Throttle tick, animation, movement and shadows of less significant characters."));
+
+    static TAutoConsoleVariable<int32> CVarFullBudget(
+        TEXT("Explorer.Significance.FullBudget"),
+        16,
+        TEXT("Number of characters, most significant first, that get full detail."));
+
+    static TAutoConsoleVariable<int32> CVarReducedBudget(
+        TEXT("Explorer.Significance.ReducedBudget"),
+        48,
+        TEXT("Number of characters after the full detail ones that get reduced detail. The rest get minimal detail."));
+
+    static TAutoConsoleVariable<float> CVarUpdateInterval(
+        TEXT("Explorer.Significance.UpdateInterval"),
+        .25f,
+        TEXT("Seconds between significance updates."));
+
+    static TAutoConsoleVariable<float> CVarReferenceDistance(
+        TEXT("Explorer.Significance.ReferenceDistance"),
+        1500.f,
+        TEXT("Distance from the view at which a character's significance has halved."));
+
+    static TAutoConsoleVariable<float> CVarHiddenScale(
+        TEXT("Explorer.Significance.HiddenScale"),
+        .1f,
+        TEXT("Significance multiplier for characters that were not rendered recently."));
+
+    /** Tick interval, in seconds, for each detail level */
+    static const float TickIntervals[EExplorerSignificance::Max] = { 0.f, 1.f / 15.f, .25f };
+
+    /** Movement simulation iterations for the reduced levels. Full detail keeps the character's own setting. */
+    static const int32 ReducedMaxSimulationIterations = 2;
+    static const int32 MinimalMaxSimulationIterations = 1;
+
+    /** A mesh rendered within this many seconds counts as visible */
+    static const float VisibleGraceSeconds = .5f;
+
+    static void DumpSignificance()
+    {
+        FExplorerSignificance::Get().Dump();
+    }
+
+    static FAutoConsoleCommand DumpCommand(
+        TEXT("Explorer.Significance.Dump"),
+        TEXT("Writes the number of characters at each detail level to the log."),
+        FConsoleCommandDelegate::CreateStatic(&DumpSignificance));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerSignificance
+#pragma mark FExplorerSignificance
+
+FExplorerSignificance& FExplorerSignificance::Get()
+{
+    static FExplorerSignificance Instance;
+    return Instance;
+}
+
+FExplorerSignificance::FExplorerSignificance()
+    : SecondsUntilUpdate(0.f)
+{
+}
+
+TStatId FExplorerSignificance::GetStatId() const
+{
+    RETURN_QUICK_DECLARE_CYCLE_STAT(FExplorerSignificance, STATGROUP_Tickables);
+}
+
+void FExplorerSignificance::Register(AExplorerCharacter* Character)
+{
+    check(Character != NULL);
+
+    for (int32 Index = 0; Index < Entries.Num(); Index++)
+    {
+        if (Entries[Index].Character.Get() == Character) return;
+    }
+
+    FEntry& entry = Entries[Entries.AddZeroed()];
+    entry.Character = Character;
+    entry.Level = EExplorerSignificance::Full;
+    entry.DefaultMaxSimulationIterations = Character->CharacterMovement->MaxSimulationIterations;
+}
+
+void FExplorerSignificance::Unregister(AExplorerCharacter* Character)
+{
+    for (int32 Index = 0; Index < Entries.Num(); Index++)
+    {
+        FEntry& entry = Entries[Index];
+        if (entry.Character.Get() != Character) continue;
+
+        // Restores the settings captured at Register, so the next Register starts from the character's own defaults
+        if (entry.Level != EExplorerSignificance::Full)
+        {
+            ApplyLevel(entry, EExplorerSignificance::Full);
+        }
+        Entries.RemoveAtSwap(Index);
+        return;
+    }
+}
+
+void FExplorerSignificance::Tick(float DeltaTime)
+{
+    SecondsUntilUpdate -= DeltaTime;
+    if (SecondsUntilUpdate > 0.f) return;
+
+    SecondsUntilUpdate = ExplorerSignificance::CVarUpdateInterval.GetValueOnGameThread();
+    UpdateSignificance();
+}
+
+void FExplorerSignificance::UpdateSignificance()
+{
+    EXPLORER_SCOPE_CYCLE_COUNTER(Significance);
+    using namespace ExplorerSignificance;
+
+    const bool bEnabled = CVarEnable.GetValueOnGameThread() != 0;
+    const float referenceDistanceSquared = FMath::Square(FMath::Max(CVarReferenceDistance.GetValueOnGameThread(), 1.f));
+    const float hiddenScale = CVarHiddenScale.GetValueOnGameThread();
+
+    // Views are looked up per world, but characters are almost always all in the same one
+    UWorld* viewWorld = NULL;
+    bool bHasView = false;
+    FVector viewLocation = FVector::ZeroVector;
+
+    // Drop destroyed characters first. Removing them while ranking would move entries the ranking already points at.
+    for (int32 Index = Entries.Num() - 1; Index >= 0; Index--)
+    {
+        if (!Entries[Index].Character.IsValid())
+        {
+            Entries.RemoveAtSwap(Index);
+        }
+    }
+
+    Ranking.Reset();
+    for (int32 Index = 0; Index < Entries.Num(); Index++)
+    {
+        AExplorerCharacter* character = Entries[Index].Character.Get();
+
+        UWorld* world = character->GetWorld();
+        if (world != viewWorld)
+        {
+            viewWorld = world;
+            bHasView = false;
+            for (FConstPlayerControllerIterator It = world->GetPlayerControllerIterator(); It; ++It)
+            {
+                APlayerController* playerController = *It;
+                if (playerController != NULL && playerController->IsLocalController())
+                {
+                    FRotator viewRotation;
+                    playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+                    bHasView = true;
+                    break;
+                }
+            }
+        }
+
+        // Only the local player's own character is exempt. AI controllers are local too, and they are the crowd.
+        FRank rank;
+        rank.Index = Index;
+        const bool bLocalPlayer = character->IsLocallyControlled() && Cast<APlayerController>(character->Controller) != NULL;
+        if (!bEnabled || !bHasView || bLocalPlayer)
+        {
+            rank.Score = MAX_FLT;
+        }
+        else
+        {
+            const float distanceSquared = FVector::DistSquared(character->GetActorLocation(), viewLocation);
+            const bool bVisible = (world->GetTimeSeconds() - character->Mesh->LastRenderTime) < VisibleGraceSeconds;
+            rank.Score = (bVisible ? 1.f : hiddenScale) / (1.f + distanceSquared / referenceDistanceSquared);
+        }
+        Ranking.Add(rank);
+    }
+
+    Ranking.Sort();
+
+    const int32 fullBudget = FMath::Max(CVarFullBudget.GetValueOnGameThread(), 0);
+    const int32 reducedBudget = FMath::Max(CVarReducedBudget.GetValueOnGameThread(), 0);
+    for (int32 Rank = 0; Rank < Ranking.Num(); Rank++)
+    {
+        FEntry& entry = Entries[Ranking[Rank].Index];
+
+        EExplorerSignificance::Type level = EExplorerSignificance::Minimal;
+        if (Ranking[Rank].Score == MAX_FLT || Rank < fullBudget) level = EExplorerSignificance::Full;
+        else if (Rank < fullBudget + reducedBudget) level = EExplorerSignificance::Reduced;
+
+        if (level != entry.Level)
+        {
+            ApplyLevel(entry, level);
+        }
+    }
+}
+
+void FExplorerSignificance::ApplyLevel(FEntry& Entry, EExplorerSignificance::Type Level)
+{
+    using namespace ExplorerSignificance;
+
+    AExplorerCharacter* character = Entry.Character.Get();
+    Entry.Level = Level;
+
+    character->SetSignificanceTickInterval(TickIntervals[Level]);
+
+    // Animation and shadows: the mesh settings also depend on the camera mode, so the character combines the two
+    character->SetSignificanceLevel(Level);
+
+    // Movement: fewer simulation substeps, and no pushing physics objects around at minimal detail
+    UCharacterMovementComponent* movement = character->CharacterMovement;
+    switch (Level)
+    {
+        case EExplorerSignificance::Full:
+            movement->MaxSimulationIterations = Entry.DefaultMaxSimulationIterations;
+            break;
+        case EExplorerSignificance::Reduced:
+            movement->MaxSimulationIterations = FMath::Min(Entry.DefaultMaxSimulationIterations, ReducedMaxSimulationIterations);
+            break;
+        default:
+            movement->MaxSimulationIterations = MinimalMaxSimulationIterations;
+            break;
+    }
+    movement->bEnablePhysicsInteraction = (Level != EExplorerSignificance::Minimal);
+}
+
+void FExplorerSignificance::Dump() const
+{
+    int32 counts[EExplorerSignificance::Max] = { 0 };
+    for (int32 Index = 0; Index < Entries.Num(); Index++)
+    {
+        if (Entries[Index].Character.IsValid()) counts[Entries[Index].Level]++;
+    }
+
+    UE_LOG(LogExplorer, Log, TEXT("Character significance: %d full, %d reduced, %d minimal"),
+        counts[EExplorerSignificance::Full], counts[EExplorerSignificance::Reduced], counts[EExplorerSignificance::Minimal]);
+}
@@ -0,0 +1,331 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerStats.h"
+#include "Tickable.h"
+
+DEFINE_STAT(STAT_ExplorerTick);
+DEFINE_STAT(STAT_ExplorerTickController);
+DEFINE_STAT(STAT_ExplorerInput);
+DEFINE_STAT(STAT_ExplorerUpdateForCameraMode);
+DEFINE_STAT(STAT_ExplorerCameraRigBlend);
+DEFINE_STAT(STAT_ExplorerFollowCamera);
+DEFINE_STAT(STAT_ExplorerCameraCollision);
+DEFINE_STAT(STAT_ExplorerSignificance);
+
+DEFINE_STAT(STAT_ExplorerFollowCharacters);
+DEFINE_STAT(STAT_ExplorerResettingCharacters);
+DEFINE_STAT(STAT_ExplorerFirstPersonCharacters);
+DEFINE_STAT(STAT_ExplorerBlendingCharacters);
+
+DEFINE_STAT(STAT_ExplorerLookLatency);
+DEFINE_STAT(STAT_ExplorerStreamingShortTextures);
+
+DEFINE_STAT(STAT_ExplorerAllocations);
+DEFINE_STAT(STAT_ExplorerAllocatedBytes);
+
+int32 FExplorerStats::NumFollowCharacters = 0;
+int32 FExplorerStats::NumResettingCharacters = 0;
+int32 FExplorerStats::NumFirstPersonCharacters = 0;
+int32 FExplorerStats::NumBlendingCharacters = 0;
+
+bool FExplorerStats::bCapturingCsv = false;
+bool FExplorerStats::bExceededBudget = false;
+int32 FExplorerStats::NumFailedChecks = 0;
+uint32 FExplorerStats::CsvFrameCycles[EExplorerCsvStat::Max] = { 0 };
+uint32 FExplorerStats::CsvFrameCalls[EExplorerCsvStat::Max] = { 0 };
+uint64 FExplorerStats::CsvTotalCycles[EExplorerCsvStat::Max] = { 0 };
+uint64 FExplorerStats::CsvTotalCalls[EExplorerCsvStat::Max] = { 0 };
+
+namespace ExplorerStats
+{
+    static const TCHAR* CsvStatNames[] =
+    {
+        TEXT("Tick"),
+        TEXT("TickController"),
+        TEXT("Input"),
+        TEXT("UpdateForCameraMode"),
+        TEXT("CameraRigBlend"),
+        TEXT("FollowCamera"),
+        TEXT("CameraCollision"),
+        TEXT("Significance"),
+    };
+    static_assert(ARRAY_COUNT(CsvStatNames) == EExplorerCsvStat::Max, "Missing CSV stat names");
+
+    static TAutoConsoleVariable<float> CVarBudgetTick(
+        TEXT("Explorer.Budget.TickMs"),
+        .05f,
+        TEXT("Average milliseconds per character Tick allowed in a CSV capture. Zero disables the check."));
+
+    static TAutoConsoleVariable<float> CVarBudgetTickController(
+        TEXT("Explorer.Budget.TickControllerMs"),
+        .05f,
+        TEXT("Average milliseconds per controller tick allowed in a CSV capture. Zero disables the check."));
+
+    static TAutoConsoleVariable<float> CVarBudgetUpdateForCameraMode(
+        TEXT("Explorer.Budget.UpdateForCameraModeMs"),
+        .1f,
+        TEXT("Average milliseconds per camera mode switch allowed in a CSV capture. Zero disables the check."));
+
+    /** The open capture */
+    static FArchive* CsvWriter = NULL;
+    static FString CsvFilename;
+    static int32 CsvFramesWritten = 0;
+    static int32 CsvFramesToWrite = 0;
+
+    static void WriteCsvLine(const FString& Line)
+    {
+        FTCHARToUTF8 utf8(*Line);
+        CsvWriter->Serialize((void*)utf8.Get(), utf8.Length());
+    }
+
+    /** Publishes the character counts and ends the CSV frame, once per frame */
+    class FCollector : public FTickableGameObject
+    {
+    public:
+        FCollector()
+            : bCheckedCommandLine(false)
+        {
+        }
+
+        virtual ~FCollector()
+        {
+            FExplorerStats::StopCsvCapture();
+        }
+
+        virtual void Tick(float DeltaTime) override
+        {
+            // Started here rather than at load so that the capture lines up with gameplay frames
+            if (!bCheckedCommandLine)
+            {
+                bCheckedCommandLine = true;
+
+                FString filename;
+                if (FParse::Value(FCommandLine::Get(), TEXT("ExplorerCsv="), filename))
+                {
+                    int32 numFrames = 0;
+                    FParse::Value(FCommandLine::Get(), TEXT("ExplorerCsvFrames="), numFrames);
+                    FExplorerStats::StartCsvCapture(filename, numFrames);
+                }
+
+                if (FParse::Param(FCommandLine::Get(), TEXT("ExplorerAllocCheck")))
+                {
+                    FExplorerAllocations::StartTracking();
+                }
+            }
+
+            SET_DWORD_STAT(STAT_ExplorerFollowCharacters, FExplorerStats::NumFollowCharacters);
+            SET_DWORD_STAT(STAT_ExplorerResettingCharacters, FExplorerStats::NumResettingCharacters);
+            SET_DWORD_STAT(STAT_ExplorerFirstPersonCharacters, FExplorerStats::NumFirstPersonCharacters);
+            SET_DWORD_STAT(STAT_ExplorerBlendingCharacters, FExplorerStats::NumBlendingCharacters);
+
+            if (FExplorerStats::IsCapturingCsv())
+            {
+                FExplorerStats::EndCsvFrame(DeltaTime);
+            }
+
+            if (FExplorerAllocations::IsTracking())
+            {
+                FExplorerAllocations::EndFrame();
+            }
+        }
+
+        virtual bool IsTickable() const override { return true; }
+
+        virtual TStatId GetStatId() const
+        {
+            RETURN_QUICK_DECLARE_CYCLE_STAT(FExplorerStatsCollector, STATGROUP_Tickables);
+        }
+
+    private:
+        bool bCheckedCommandLine;
+    };
+
+    static FCollector& GetCollector()
+    {
+        static FCollector Collector;
+        return Collector;
+    }
+
+    static void StartCsv(const TArray<FString>& Args)
+    {
+        FExplorerStats::StartCsvCapture((Args.Num() > 0) ? Args[0] : FString());
+    }
+
+    static FAutoConsoleCommand StartCsvCommand(
+        TEXT("Explorer.Csv.Start"),
+        TEXT("Starts capturing Explorer timings to a CSV file, one row per frame. Optional argument: file name."),
+        FConsoleCommandWithArgsDelegate::CreateStatic(&StartCsv));
+
+    static FAutoConsoleCommand StopCsvCommand(
+        TEXT("Explorer.Csv.Stop"),
+        TEXT("Stops the Explorer CSV capture."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerStats::StopCsvCapture));
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerStats
+#pragma mark FExplorerStats
+
+void FExplorerStats::Initialize()
+{
+    ExplorerStats::GetCollector();
+}
+
+const TCHAR* FExplorerStats::GetCsvStatName(EExplorerCsvStat::Type Stat)
+{
+    return ExplorerStats::CsvStatNames[Stat];
+}
+
+void FExplorerStats::UpdateCharacterCounts(uint8 OldCounts, uint8 NewCounts)
+{
+    const uint8 added = NewCounts & ~OldCounts;
+    const uint8 removed = OldCounts & ~NewCounts;
+
+    NumFollowCharacters += ((added & FollowCount) ? 1 : 0) - ((removed & FollowCount) ? 1 : 0);
+    NumResettingCharacters += ((added & ResettingCount) ? 1 : 0) - ((removed & ResettingCount) ? 1 : 0);
+    NumFirstPersonCharacters += ((added & FirstPersonCount) ? 1 : 0) - ((removed & FirstPersonCount) ? 1 : 0);
+    NumBlendingCharacters += ((added & BlendingCount) ? 1 : 0) - ((removed & BlendingCount) ? 1 : 0);
+}
+
+bool FExplorerStats::StartCsvCapture(const FString& Filename, int32 NumFrames)
+{
+    using namespace ExplorerStats;
+
+    StopCsvCapture();
+
+    CsvFilename = Filename;
+    if (CsvFilename.IsEmpty())
+    {
+        CsvFilename = FPaths::ProfilingDir() / FString::Printf(TEXT("Explorer-%s.csv"), *FDateTime::Now().ToString());
+    }
+
+    CsvWriter = IFileManager::Get().CreateFileWriter(*CsvFilename);
+    if (CsvWriter == NULL)
+    {
+        UE_LOG(LogExplorer, Warning, TEXT("Could not open %s for the CSV capture"), *CsvFilename);
+        return false;
+    }
+
+    FString header = TEXT("Frame,FrameMs");
+    for (int32 Stat = 0; Stat < EExplorerCsvStat::Max; Stat++)
+    {
+        header += FString::Printf(TEXT(",%sMs,%sCalls"), CsvStatNames[Stat], CsvStatNames[Stat]);
+    }
+    header += TEXT(",FollowCharacters,ResettingCharacters,FirstPersonCharacters\n");
+    WriteCsvLine(header);
+
+    FMemory::Memzero(CsvFrameCycles, sizeof(CsvFrameCycles));
+    FMemory::Memzero(CsvFrameCalls, sizeof(CsvFrameCalls));
+    FMemory::Memzero(CsvTotalCycles, sizeof(CsvTotalCycles));
+    FMemory::Memzero(CsvTotalCalls, sizeof(CsvTotalCalls));
+    CsvFramesWritten = 0;
+    CsvFramesToWrite = FMath::Max(NumFrames, 0);
+    bCapturingCsv = true;
+
+    UE_LOG(LogExplorer, Log, TEXT("Capturing Explorer timings to %s"), *CsvFilename);
+    return true;
+}
+
+void FExplorerStats::StopCsvCapture()
+{
+    using namespace ExplorerStats;
+
+    if (CsvWriter == NULL) return;
+
+    bCapturingCsv = false;
+    CsvWriter->Close();
+    delete CsvWriter;
+    CsvWriter = NULL;
+
+    UE_LOG(LogExplorer, Log, TEXT("Captured %d frames to %s"), CsvFramesWritten, *CsvFilename);
+
+    CheckBudgets();
+}
+
+void FExplorerStats::CheckBudgets()
+{
+    using namespace ExplorerStats;
+
+    struct FBudget
+    {
+        EExplorerCsvStat::Type Stat;
+        float Milliseconds;
+    };
+    const FBudget budgets[] =
+    {
+        { EExplorerCsvStat::Tick, CVarBudgetTick.GetValueOnGameThread() },
+        { EExplorerCsvStat::TickController, CVarBudgetTickController.GetValueOnGameThread() },
+        { EExplorerCsvStat::UpdateForCameraMode, CVarBudgetUpdateForCameraMode.GetValueOnGameThread() },
+    };
+
+    for (int32 Index = 0; Index < ARRAY_COUNT(budgets); Index++)
+    {
+        const FBudget& budget = budgets[Index];
+        const uint64 calls = CsvTotalCalls[budget.Stat];
+        if (budget.Milliseconds <= 0.f || calls == 0) continue;
+
+        const double averageMs = FPlatformTime::ToMilliseconds(1) * ((double)CsvTotalCycles[budget.Stat] / calls);
+        if (averageMs > budget.Milliseconds)
+        {
+            bExceededBudget = true;
+            NoteFailedCheck();
+            UE_LOG(LogExplorer, Error, TEXT("Budget exceeded: %s averaged %.4f ms over %llu calls (budget %.4f ms)"), CsvStatNames[budget.Stat], averageMs, calls, budget.Milliseconds);
+        }
+        else
+        {
+            UE_LOG(LogExplorer, Log, TEXT("Budget met: %s averaged %.4f ms over %llu calls (budget %.4f ms)"), CsvStatNames[budget.Stat], averageMs, calls, budget.Milliseconds);
+        }
+    }
+}
+
+void FExplorerStats::ExitHeadlessRun(const TCHAR* RunName)
+{
+    // End any CSV capture now, so its budget check makes it into the log before exit
+    StopCsvCapture();
+
+    // With -ExplorerAllocCheck, any frame that allocated after the warm up fails the run
+    FExplorerAllocations::StopTracking();
+    if (FExplorerAllocations::HasSteadyStateAllocations())
+    {
+        UE_LOG(LogExplorer, Error, TEXT("%s allocated after the warm up"), RunName);
+        NoteFailedCheck();
+    }
+
+    if (NumFailedChecks == 0)
+    {
+        UE_LOG(LogExplorer, Log, TEXT("%s passed"), RunName);
+        FPlatformMisc::RequestExit(false);
+        return;
+    }
+
+    // A normal exit returns zero whatever was logged. A forced exit with GIsCriticalError set does not.
+    UE_LOG(LogExplorer, Error, TEXT("%s failed %d check(s)"), RunName, NumFailedChecks);
+    GIsCriticalError = true;
+    GLog->Flush();
+    FPlatformMisc::RequestExit(true);
+}
+
+void FExplorerStats::EndCsvFrame(float DeltaSeconds)
+{
+    using namespace ExplorerStats;
+
+    FString line = FString::Printf(TEXT("%llu,%.3f"), (uint64)GFrameCounter, DeltaSeconds * 1000.f);
+    for (int32 Stat = 0; Stat < EExplorerCsvStat::Max; Stat++)
+    {
+        line += FString::Printf(TEXT(",%.4f,%u"), FPlatformTime::ToMilliseconds(CsvFrameCycles[Stat]), CsvFrameCalls[Stat]);
+        CsvTotalCycles[Stat] += CsvFrameCycles[Stat];
+        CsvTotalCalls[Stat] += CsvFrameCalls[Stat];
+    }
+    line += FString::Printf(TEXT(",%d,%d,%d\n"), NumFollowCharacters, NumResettingCharacters, NumFirstPersonCharacters);
+    WriteCsvLine(line);
+
+    FMemory::Memzero(CsvFrameCycles, sizeof(CsvFrameCycles));
+    FMemory::Memzero(CsvFrameCalls, sizeof(CsvFrameCalls));
+
+    CsvFramesWritten++;
+    if (CsvFramesToWrite > 0 && CsvFramesWritten >= CsvFramesToWrite)
+    {
+        StopCsvCapture();
+    }
+}
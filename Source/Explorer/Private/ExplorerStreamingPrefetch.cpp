@@ -0,0 +1,197 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerStreamingPrefetch.h"
+#include "ExplorerStats.h"
+#include "Engine.h"
+
+namespace ExplorerStreamingPrefetch
+{
+    static TAutoConsoleVariable<int32> CVarPredict(
+        TEXT("Explorer.Streaming.Predict"),
+        1,
+        TEXT("Whether the camera registers its predicted viewpoints with the texture streamer."));
+
+    /** Slowest turn worth predicting, in degrees per second. Anything slower stays within what is already streamed. */
+    static const float MinPredictedYawRate = 45.f;
+
+#if EXPLORER_STREAMING_MEASURE
+    static TAutoConsoleVariable<int32> CVarMeasure(
+        TEXT("Explorer.Streaming.Measure"),
+        0,
+        TEXT("Whether to count, every frame, the visible textures short of the mips the view wants. Walks the whole world."));
+
+    /** How recently a primitive must have been rendered to count as on screen */
+    static const float VisibleSeconds = .1f;
+
+    /** Screen width used for the wanted mips when there is no game viewport */
+    static const float DefaultScreenWidth = 1280.f;
+
+    /** Frames measured, and frames with textures short of mips, [0] without prediction and [1] with */
+    static uint64 NumFrames[2] = { 0, 0 };
+    static uint64 NumUnstreamedFrames[2] = { 0, 0 };
+
+    static FAutoConsoleCommand DumpCommand(
+        TEXT("Explorer.Streaming.Dump"),
+        TEXT("Writes how many frames showed textures short of the mips the view wants, with and without camera prediction, to the log."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerStreamingPrefetch::Dump));
+
+    static FAutoConsoleCommand ResetCommand(
+        TEXT("Explorer.Streaming.Reset"),
+        TEXT("Clears the camera streaming prefetch results."),
+        FConsoleCommandDelegate::CreateStatic(&FExplorerStreamingPrefetch::Reset));
+#endif // EXPLORER_STREAMING_MEASURE
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerStreamingPrefetch
+#pragma mark FExplorerStreamingPrefetch
+
+FExplorerStreamingPrefetch::FExplorerStreamingPrefetch()
+    : PreviousYaw(0.f)
+    , HasPreviousYaw(false)
+{
+}
+
+void FExplorerStreamingPrefetch::NoteView(UWorld* World, const FView& View, float DeltaSeconds)
+{
+    using namespace ExplorerStreamingPrefetch;
+
+    const float yawRate = (HasPreviousYaw && DeltaSeconds > 0.f) ? FRotator::NormalizeAxis(View.Rotation.Yaw - PreviousYaw) / DeltaSeconds : 0.f;
+    PreviousYaw = View.Rotation.Yaw;
+    HasPreviousYaw = true;
+
+    const bool bPredict = CVarPredict.GetValueOnGameThread() != 0 && View.HorizonSeconds > 0.f;
+    if (bPredict)
+    {
+        // A reset ends behind the mesh, however far away that is
+        if (View.bResetting)
+        {
+            AddPredictedView(View, View.ResetTargetYaw);
+        }
+
+        // A fast turn carries on for a while, more or less at the same rate
+        if (FMath::Abs(yawRate) >= MinPredictedYawRate)
+        {
+            AddPredictedView(View, View.Rotation.Yaw + yawRate * View.HorizonSeconds);
+        }
+    }
+
+#if EXPLORER_STREAMING_MEASURE
+    // Counts what this frame shows, which was streamed for with last frame's prediction
+    if (CVarMeasure.GetValueOnGameThread() != 0)
+    {
+        const int32 numShort = CountVisibleTexturesShortOfMips(World, View);
+        SET_DWORD_STAT(STAT_ExplorerStreamingShortTextures, numShort);
+
+        NumFrames[bPredict ? 1 : 0]++;
+        if (numShort > 0)
+        {
+            NumUnstreamedFrames[bPredict ? 1 : 0]++;
+        }
+    }
+#endif
+}
+
+#if EXPLORER_STREAMING_MEASURE
+
+int32 FExplorerStreamingPrefetch::CountVisibleTexturesShortOfMips(UWorld* World, const FView& View)
+{
+    using namespace ExplorerStreamingPrefetch;
+
+    if (World == NULL) return 0;
+
+    // Texels across the screen per unit of texel factor at unit distance, as the streamer works it out for a view
+    FVector2D screenSize(0.f, 0.f);
+    if (GEngine->GameViewport != NULL)
+    {
+        GEngine->GameViewport->GetViewportSize(screenSize);
+    }
+    const float screenWidth = (screenSize.X > 0.f) ? screenSize.X : DefaultScreenWidth;
+    const float screenSizeFactor = screenWidth / FMath::Tan(FMath::DegreesToRadians(FMath::Clamp(View.FOV, 1.f, 179.f) * .5f));
+
+    ShortTextures.Reset();
+    const float worldSeconds = World->GetTimeSeconds();
+    for (FActorIterator It(World); It; ++It)
+    {
+        if (worldSeconds - It->GetLastRenderTime() > VisibleSeconds) continue;
+
+        Components.Reset();
+        It->GetComponents(Components);
+        for (int32 ComponentIndex = 0; ComponentIndex < Components.Num(); ComponentIndex++)
+        {
+            UPrimitiveComponent* component = Components[ComponentIndex];
+            if (!component->IsRegistered() || worldSeconds - component->LastRenderTime > VisibleSeconds) continue;
+
+            TextureInfos.Reset();
+            component->GetStreamingTextureInfo(TextureInfos);
+            for (int32 Index = 0; Index < TextureInfos.Num(); Index++)
+            {
+                const FStreamingTexturePrimitiveInfo& info = TextureInfos[Index];
+                UTexture2D* texture = Cast<UTexture2D>(info.Texture);
+                if (texture == NULL || texture->ResidentMips >= texture->GetNumMips()) continue;
+
+                // Mips for the texels this primitive covers on screen, from this view only, so the predicted
+                // viewpoints' requests neither count nor hide anything
+                const float distance = FMath::Max(FVector::Dist(View.Location, info.Bounds.Center) - info.Bounds.W, 1.f);
+                const float screenTexels = FMath::Max(info.TexelFactor * screenSizeFactor / distance, 1.f);
+                const int32 wantedMips = FMath::Min(FMath::CeilToInt(FMath::Log2(screenTexels)) + 1, texture->GetNumMips());
+                if (texture->ResidentMips < wantedMips)
+                {
+                    ShortTextures.Add((UPTRINT)texture);
+                }
+            }
+        }
+    }
+
+    // A texture on several primitives is counted once
+    ShortTextures.Sort();
+    int32 numShort = 0;
+    for (int32 Index = 0; Index < ShortTextures.Num(); Index++)
+    {
+        if (Index == 0 || ShortTextures[Index] != ShortTextures[Index - 1]) numShort++;
+    }
+    return numShort;
+}
+
+#endif // EXPLORER_STREAMING_MEASURE
+
+void FExplorerStreamingPrefetch::AddPredictedView(const FView& View, float Yaw)
+{
+    // Swung around the pivot, keeping the pitch and the (possibly collision shortened) arm of the current view
+    const FVector arm = View.Location - View.Pivot;
+    const FVector location = View.Pivot + FRotator(0.f, FRotator::NormalizeAxis(Yaw - View.Rotation.Yaw), 0.f).RotateVector(arm);
+
+    // Slave locations only count for the streaming update that follows, so they are added every frame
+    IStreamingManager::Get().AddViewSlaveLocation(location);
+}
+
+#if EXPLORER_STREAMING_MEASURE
+
+void FExplorerStreamingPrefetch::Dump()
+{
+    using namespace ExplorerStreamingPrefetch;
+
+    static const TCHAR* Labels[2] = { TEXT("without prediction"), TEXT("with prediction") };
+    for (int32 Index = 0; Index < 2; Index++)
+    {
+        if (NumFrames[Index] == 0)
+        {
+            UE_LOG(LogExplorer, Log, TEXT("Streaming %s: no frames measured (see Explorer.Streaming.Measure)"), Labels[Index]);
+            continue;
+        }
+
+        UE_LOG(LogExplorer, Log, TEXT("Streaming %s: %llu of %llu frames (%.1f%%) showed textures short of the mips the view wants"),
+            Labels[Index], NumUnstreamedFrames[Index], NumFrames[Index], 100.0 * NumUnstreamedFrames[Index] / NumFrames[Index]);
+    }
+}
+
+void FExplorerStreamingPrefetch::Reset()
+{
+    using namespace ExplorerStreamingPrefetch;
+
+    FMemory::Memzero(NumFrames, sizeof(NumFrames));
+    FMemory::Memzero(NumUnstreamedFrames, sizeof(NumUnstreamedFrames));
+}
+
+#endif // EXPLORER_STREAMING_MEASURE
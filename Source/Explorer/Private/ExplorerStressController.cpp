@@ -0,0 +1,139 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerStressController.h"
+#include "ExplorerCharacter.h"
+
+namespace ExplorerStressController
+{
+    /** The phases in the order they are run. Walking between the others keeps the characters spread out. */
+    static const EExplorerStressPhase::Type Script[] =
+    {
+        EExplorerStressPhase::CameraAndZoom,
+        EExplorerStressPhase::Walk,
+        EExplorerStressPhase::LookAround,
+        EExplorerStressPhase::Walk,
+        EExplorerStressPhase::Idle,
+    };
+
+    /** Chance per second of a jump while walking */
+    static const float JumpsPerSecond = .5f;
+
+    /** How long past the auto reset delay to stay idle, so the reset has time to run */
+    static const float IdleMarginSeconds = 3.f;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// AExplorerStressController
+#pragma mark AExplorerStressController
+
+AExplorerStressController::AExplorerStressController(const class FPostConstructInitializeProperties& PCIP)
+    : Super(PCIP)
+    , ScriptStep(-1)
+    , Phase(EExplorerStressPhase::CameraAndZoom)
+    , PhaseSeconds(0.f)
+    , PhaseDuration(0.f)
+    , SecondsUntilZoom(0.f)
+{
+    PrimaryActorTick.bCanEverTick = true;
+}
+
+void AExplorerStressController::SetScriptSeed(int32 Seed)
+{
+    Random.Initialize(Seed);
+
+    // Start somewhere different in the script too
+    ScriptStep = Random.RandHelper(ARRAY_COUNT(ExplorerStressController::Script)) - 1;
+    PhaseDuration = 0.f;
+}
+
+void AExplorerStressController::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    AExplorerCharacter* character = Cast<AExplorerCharacter>(GetPawn());
+    if (character == NULL) return;
+
+    PhaseSeconds += DeltaSeconds;
+    if (PhaseSeconds >= PhaseDuration)
+    {
+        StartNextPhase();
+    }
+
+    BuildFrame(DeltaSeconds);
+    character->ApplyInputFrame(Frame);
+}
+
+void AExplorerStressController::StartNextPhase()
+{
+    using namespace ExplorerStressController;
+
+    ScriptStep = (ScriptStep + 1) % ARRAY_COUNT(Script);
+    Phase = Script[ScriptStep];
+    PhaseSeconds = 0.f;
+    SecondsUntilZoom = 0.f;
+
+    switch (Phase)
+    {
+        case EExplorerStressPhase::CameraAndZoom:
+            PhaseDuration = Random.FRandRange(1.f, 2.f);
+            break;
+        case EExplorerStressPhase::Walk:
+            PhaseDuration = Random.FRandRange(2.f, 5.f);
+            break;
+        case EExplorerStressPhase::LookAround:
+            PhaseDuration = Random.FRandRange(2.f, 4.f);
+            break;
+        default:
+        {
+            AExplorerCharacter* character = Cast<AExplorerCharacter>(GetPawn());
+            PhaseDuration = ((character != NULL) ? character->GetCameraProfile().AutoResetDelaySeconds : 0.f) + IdleMarginSeconds;
+            break;
+        }
+    }
+}
+
+void AExplorerStressController::BuildFrame(float DeltaSeconds)
+{
+    using namespace ExplorerStressController;
+
+    Frame.Reset();
+    Frame.DeltaSeconds = DeltaSeconds;
+
+    switch (Phase)
+    {
+        case EExplorerStressPhase::CameraAndZoom:
+            // Phases start with PhaseSeconds at zero, so this switches mode once per phase
+            if (PhaseSeconds == 0.f)
+            {
+                Frame.ActionMask |= 1 << EExplorerInputTraceAction::ToggleCameraMode;
+            }
+
+            SecondsUntilZoom -= DeltaSeconds;
+            if (SecondsUntilZoom <= 0.f)
+            {
+                SecondsUntilZoom = Random.FRandRange(.1f, .4f);
+                Frame.ActionMask |= 1 << (Random.FRand() < .5f ? EExplorerInputTraceAction::ZoomIn : EExplorerInputTraceAction::ZoomOut);
+            }
+            break;
+
+        case EExplorerStressPhase::Walk:
+            Frame.Axes[EExplorerInputTraceAxis::MoveForward] = 1.f;
+            Frame.Axes[EExplorerInputTraceAxis::MoveRight] = FMath::Sin(PhaseSeconds * 1.3f) * .5f;
+            if (Random.FRand() < JumpsPerSecond * DeltaSeconds)
+            {
+                Frame.ActionMask |= 1 << EExplorerInputTraceAction::Jump;
+            }
+            break;
+
+        case EExplorerStressPhase::LookAround:
+            Frame.Axes[EExplorerInputTraceAxis::MoveForward] = .5f;
+            Frame.Axes[EExplorerInputTraceAxis::TurnRate] = FMath::Sin(PhaseSeconds * 2.f);
+            Frame.Axes[EExplorerInputTraceAxis::LookUpRate] = FMath::Sin(PhaseSeconds * 3.f) * .3f;
+            break;
+
+        default:
+            // No input at all, so the character goes idle and the follow camera auto resets
+            break;
+    }
+}
@@ -0,0 +1,177 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerStressGameMode.h"
+#include "ExplorerStressController.h"
+#include "ExplorerCharacter.h"
+#include "ExplorerStats.h"
+#include "Engine.h"
+
+namespace ExplorerStressGameMode
+{
+    /** Frame rate used to size the sample arrays */
+    static const int32 ExpectedFramesPerSecond = 120;
+
+    /** Value below which Percentile of the sorted samples fall */
+    static float GetPercentile(const TArray<float>& SortedSamples, float Percentile)
+    {
+        if (SortedSamples.Num() == 0) return 0.f;
+
+        const int32 index = FMath::Clamp(FMath::RoundToInt(Percentile * (SortedSamples.Num() - 1)), 0, SortedSamples.Num() - 1);
+        return SortedSamples[index];
+    }
+
+    static float GetAverage(const TArray<float>& Samples)
+    {
+        if (Samples.Num() == 0) return 0.f;
+
+        double total = 0.0;
+        for (int32 Index = 0; Index < Samples.Num(); Index++)
+        {
+            total += Samples[Index];
+        }
+        return (float)(total / Samples.Num());
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// AExplorerStressGameMode
+#pragma mark AExplorerStressGameMode
+
+AExplorerStressGameMode::AExplorerStressGameMode(const class FPostConstructInitializeProperties& PCIP)
+    : Super(PCIP)
+    , NumCharacters(100)
+    , StressSeconds(60.f)
+    , WarmUpSeconds(5.f)
+    , SpawnSpacing(250.f)
+    , ElapsedSeconds(0.f)
+    , CrowdSpawned(false)
+    , IsFinished(false)
+    , ExitWhenFinished(false)
+{
+    PrimaryActorTick.bCanEverTick = true;
+}
+
+void AExplorerStressGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+    Super::InitGame(MapName, Options, ErrorMessage);
+
+    NumCharacters = FMath::Max(GetIntOption(Options, TEXT("StressCharacters"), NumCharacters), 0);
+    if (HasOption(Options, TEXT("StressSeconds")))
+    {
+        StressSeconds = FCString::Atof(*ParseOption(Options, TEXT("StressSeconds")));
+    }
+    ExitWhenFinished = HasOption(Options, TEXT("StressExit"));
+
+    const int32 expectedFrames = FMath::CeilToInt(FMath::Max(StressSeconds, 0.f) * ExplorerStressGameMode::ExpectedFramesPerSecond);
+    FrameMilliseconds.Empty(expectedFrames);
+    GameThreadMilliseconds.Empty(expectedFrames);
+}
+
+void AExplorerStressGameMode::StartPlay()
+{
+    Super::StartPlay();
+
+    SpawnCrowd();
+}
+
+void AExplorerStressGameMode::OnPawnClassLoaded()
+{
+    Super::OnPawnClassLoaded();
+
+    SpawnCrowd();
+}
+
+void AExplorerStressGameMode::SpawnCrowd()
+{
+    // The crowd uses the streamed in pawn class, so it waits for both
+    if (CrowdSpawned || !IsPawnClassLoaded() || !GetWorld()->HasBegunPlay()) return;
+    CrowdSpawned = true;
+
+    UClass* characterClass = CharacterClass;
+    if (characterClass == NULL)
+    {
+        characterClass = (DefaultPawnClass != NULL && DefaultPawnClass->IsChildOf(AExplorerCharacter::StaticClass())) ? *DefaultPawnClass : AExplorerCharacter::StaticClass();
+    }
+
+    AActor* playerStart = FindPlayerStart(NULL);
+    const FVector origin = (playerStart != NULL) ? playerStart->GetActorLocation() : FVector::ZeroVector;
+    const FRotator rotation = (playerStart != NULL) ? playerStart->GetActorRotation() : FRotator::ZeroRotator;
+
+    FActorSpawnParameters spawnParameters;
+    spawnParameters.bNoCollisionFail = true;
+
+    // A square grid in front of the player start, leaving the start itself free for the player
+    const int32 columns = FMath::Max(FMath::CeilToInt(FMath::Sqrt((float)NumCharacters)), 1);
+    int32 numSpawned = 0;
+    for (int32 Index = 0; Index < NumCharacters; Index++)
+    {
+        const FVector offset((Index / columns + 1) * SpawnSpacing, (Index % columns - columns / 2) * SpawnSpacing, 0.f);
+        AExplorerCharacter* character = GetWorld()->SpawnActor<AExplorerCharacter>(characterClass, origin + rotation.RotateVector(offset), rotation, spawnParameters);
+        if (character == NULL) continue;
+
+        AExplorerStressController* controller = GetWorld()->SpawnActor<AExplorerStressController>(spawnParameters);
+        if (controller == NULL)
+        {
+            character->Destroy();
+            continue;
+        }
+
+        controller->SetScriptSeed(Index);
+        controller->Possess(character);
+        numSpawned++;
+    }
+
+    UE_LOG(LogExplorer, Log, TEXT("Stress test: spawned %d %s characters, measuring for %.0f seconds after a %.0f second warm up"),
+        numSpawned, *characterClass->GetName(), StressSeconds, WarmUpSeconds);
+}
+
+void AExplorerStressGameMode::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    if (IsFinished || !CrowdSpawned) return;
+
+    ElapsedSeconds += DeltaSeconds;
+    if (ElapsedSeconds < WarmUpSeconds) return;
+
+    FrameMilliseconds.Add(DeltaSeconds * 1000.f);
+    GameThreadMilliseconds.Add(FPlatformTime::ToMilliseconds(GGameThreadTime));
+
+    if (ElapsedSeconds >= WarmUpSeconds + StressSeconds)
+    {
+        IsFinished = true;
+        Report();
+
+        if (ExitWhenFinished)
+        {
+            FExplorerStats::ExitHeadlessRun(TEXT("Stress test"));
+        }
+    }
+}
+
+void AExplorerStressGameMode::Report()
+{
+    using namespace ExplorerStressGameMode;
+
+    TArray<float> sortedFrames = FrameMilliseconds;
+    sortedFrames.Sort();
+    TArray<float> sortedGameThread = GameThreadMilliseconds;
+    sortedGameThread.Sort();
+
+    const FPlatformMemoryStats memory = FPlatformMemory::GetStats();
+    const float megabyte = 1024.f * 1024.f;
+
+    UE_LOG(LogExplorer, Log, TEXT("Stress test: %d characters, %d frames over %.1f seconds"), NumCharacters, sortedFrames.Num(), ElapsedSeconds - WarmUpSeconds);
+    UE_LOG(LogExplorer, Log, TEXT("  Frame ms:       avg %.2f  p50 %.2f  p90 %.2f  p99 %.2f  max %.2f"),
+        GetAverage(sortedFrames), GetPercentile(sortedFrames, .5f), GetPercentile(sortedFrames, .9f), GetPercentile(sortedFrames, .99f), GetPercentile(sortedFrames, 1.f));
+    UE_LOG(LogExplorer, Log, TEXT("  Game thread ms: avg %.2f  p50 %.2f  p90 %.2f  p99 %.2f  max %.2f"),
+        GetAverage(sortedGameThread), GetPercentile(sortedGameThread, .5f), GetPercentile(sortedGameThread, .9f), GetPercentile(sortedGameThread, .99f), GetPercentile(sortedGameThread, 1.f));
+    UE_LOG(LogExplorer, Log, TEXT("  Memory MB:      used %.1f  peak %.1f"), memory.UsedPhysical / megabyte, memory.PeakUsedPhysical / megabyte);
+    UE_LOG(LogExplorer, Log, TEXT("  Camera modes:   %d follow, %d resetting, %d first person"),
+        FExplorerStats::NumFollowCharacters, FExplorerStats::NumResettingCharacters, FExplorerStats::NumFirstPersonCharacters);
+
+    // With -ExplorerAllocCheck the scripted controllers double as the allocation test, cycling every camera mode.
+    // Unattended runs fail on steady state allocations when they exit.
+    FExplorerAllocations::StopTracking();
+}
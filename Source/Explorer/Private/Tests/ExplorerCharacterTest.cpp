@@ -0,0 +1,374 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerCharacter.h"
+#include "ExplorerCameraProfile.h"
+#include "ExplorerFollowCameraSolver.h"
+#include "ExplorerInputTrace.h"
+#include "ExplorerStats.h"
+#include "AIController.h"
+#include "Engine.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ Headless automation tests for AExplorerCharacter.
+
+ Each test builds its own game world, spawns a character possessed by an AI controller and drives it through
+ ApplyInputFrame, the same entry point input trace replays and the stress controllers use. The test ticks the world
+ itself at a fixed 60 Hz, so results do not depend on the machine's frame rate. Run them without a window:
+
+     UE4Editor <project> -game -nullrhi -unattended -ExecCmds="Automation RunTests Explorer.Character; Quit"
+ */
+
+namespace ExplorerCharacterTest
+{
+    static const float FrameSeconds = 1.f / 60.f;
+
+    /** A game world that only ticks when the test tells it to, with one possessed character in it */
+    class FTestWorld
+    {
+    public:
+        FTestWorld()
+            : World(UWorld::CreateWorld(EWorldType::Game, false))
+            , PreviousWorld(GWorld)
+            , Character(NULL)
+            , Controller(NULL)
+        {
+            FWorldContext& worldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+            worldContext.SetCurrentWorld(World);
+            GWorld = World;
+
+            World->InitializeActorsForPlay(FURL());
+            World->BeginPlay(FURL());
+
+            FActorSpawnParameters spawnParameters;
+            spawnParameters.bNoCollisionFail = true;
+            Character = World->SpawnActor<AExplorerCharacter>(AExplorerCharacter::StaticClass(), FVector::ZeroVector, FRotator::ZeroRotator, spawnParameters);
+            Controller = World->SpawnActor<AAIController>(spawnParameters);
+            if (Character != NULL && Controller != NULL)
+            {
+                Controller->Possess(Character);
+
+                // The world is empty, so there is no floor to walk on and falling would end at the kill Z
+                Character->CharacterMovement->SetMovementMode(MOVE_Flying);
+            }
+        }
+
+        ~FTestWorld()
+        {
+            GWorld = PreviousWorld;
+            GEngine->DestroyWorldContext(World);
+            World->DestroyWorld(false);
+        }
+
+        bool IsValid() const
+        {
+            return Character != NULL && Controller != NULL && Character->Controller == Controller;
+        }
+
+        /** Applies Input, as a replay frame would, then advances the world by one frame */
+        void Tick(const FExplorerInputTraceFrame& Input)
+        {
+            Character->ApplyInputFrame(Input);
+            World->Tick(LEVELTICK_All, FrameSeconds);
+
+            // The stats collector is ticked by the engine loop, which is not running the test world
+            if (FExplorerStats::IsCapturingCsv())
+            {
+                FExplorerStats::EndCsvFrame(FrameSeconds);
+            }
+        }
+
+        /** Advances the world by a number of frames without any input */
+        void TickIdle(int32 NumFrames)
+        {
+            const FExplorerInputTraceFrame noInput;
+            for (int32 Frame = 0; Frame < NumFrames; Frame++)
+            {
+                Tick(noInput);
+            }
+        }
+
+        /**
+         * Cycles the camera mode, as the player would, until Mode is active, then lets the rig blend finish.
+         * @return false if Mode never came round
+         */
+        bool SwitchToCameraMode(ECharacterCameraMode::Type Mode)
+        {
+            FExplorerInputTraceFrame toggle;
+            toggle.ActionMask = 1 << EExplorerInputTraceAction::ToggleCameraMode;
+
+            for (int32 Attempt = 0; Attempt < ECharacterCameraMode::Max && Character->CameraModeEnum != Mode; Attempt++)
+            {
+                Tick(toggle);
+            }
+
+            TickIdle(FMath::CeilToInt(Character->GetCameraProfile().CameraModeBlendSeconds / FrameSeconds) + 1);
+            return Character->CameraModeEnum == Mode;
+        }
+
+        /** The yaw a follow camera reset swings the control rotation to */
+        float GetResetTargetYaw() const
+        {
+            return Character->Mesh->GetTransformMatrix().Rotator().Yaw + FExplorerFollowCameraParams().MeshYawOffset;
+        }
+
+        /** Signed degrees from the control yaw to the reset target, the short way round */
+        float GetResetOffset() const
+        {
+            return FRotator::NormalizeAxis(GetResetTargetYaw() - Controller->GetControlRotation().Yaw);
+        }
+
+        /** Turns the controller so the reset target is Offset degrees away */
+        void SetResetOffset(float Offset)
+        {
+            Controller->SetControlRotation(FRotator(0.f, FRotator::ClampAxis(GetResetTargetYaw() - Offset), 0.f));
+        }
+
+        UWorld* World;
+        UWorld* PreviousWorld;
+        AExplorerCharacter* Character;
+        AAIController* Controller;
+    };
+
+    static const ECharacterCameraMode::Type AllCameraModes[] =
+    {
+        ECharacterCameraMode::ThirdPersonDefault,
+        ECharacterCameraMode::FirstPerson,
+        ECharacterCameraMode::ThirdPersonFollow,
+    };
+
+    /**
+     * Frames an exponential reset from StartDegrees should take to get within the solver's tolerance. Each simulation
+     * step turns by Speed * StepSeconds of what is left. AI controllers apply yaw input unscaled.
+     */
+    static int32 GetExpectedResetFrames(float StartDegrees, float Speed, float StepSeconds)
+    {
+        const float tolerance = FExplorerFollowCameraParams().ResetToleranceDegrees;
+        const float steps = FMath::Loge(tolerance / StartDegrees) / FMath::Loge(1.f - Speed * StepSeconds);
+        return FMath::CeilToInt(steps * StepSeconds / FrameSeconds);
+    }
+
+    /**
+     * Runs a reset to the end, checking every frame that it only ever closes in on its target.
+     * @return Frames the reset took, or MaxFrames + 1 if it did not finish
+     */
+    static int32 RunReset(FAutomationTestBase& Test, FTestWorld& TestWorld, int32 MaxFrames, const FString& What)
+    {
+        const float startOffset = TestWorld.GetResetOffset();
+        float previousDistance = FMath::Abs(startOffset);
+        float travelled = 0.f;
+        float previousYaw = TestWorld.Controller->GetControlRotation().Yaw;
+
+        int32 Frame = 0;
+        for (; Frame <= MaxFrames && TestWorld.Character->IsCameraResetting(); Frame++)
+        {
+            TestWorld.TickIdle(1);
+
+            const float yaw = TestWorld.Controller->GetControlRotation().Yaw;
+            const float step = FRotator::NormalizeAxis(yaw - previousYaw);
+            previousYaw = yaw;
+            travelled += step;
+
+            const float distance = FMath::Abs(TestWorld.GetResetOffset());
+            if (distance > previousDistance + KINDA_SMALL_NUMBER)
+            {
+                Test.AddError(FString::Printf(TEXT("%s: frame %d moved away from the target (%.3f -> %.3f degrees)"), *What, Frame, previousDistance, distance));
+                break;
+            }
+            previousDistance = distance;
+        }
+
+        // Turning the short way, the camera never travels further than it started from its target, and in the same direction
+        Test.TestTrue(FString::Printf(TEXT("%s: turns towards the target the short way (%.2f degrees to go, travelled %.2f)"), *What, startOffset, travelled),
+            FMath::Abs(travelled) <= FMath::Abs(startOffset) + KINDA_SMALL_NUMBER && travelled * startOffset >= 0.f);
+        return Frame;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Zoom
+#pragma mark Zoom
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExplorerCharacterZoomTest, "Explorer.Character.ZoomClamp", EAutomationTestFlags::ATF_Game)
+
+bool FExplorerCharacterZoomTest::RunTest(const FString& Parameters)
+{
+    using namespace ExplorerCharacterTest;
+
+    FTestWorld testWorld;
+    if (!testWorld.IsValid())
+    {
+        AddError(TEXT("Could not spawn a possessed AExplorerCharacter"));
+        return false;
+    }
+
+    const UExplorerCameraProfile& profile = testWorld.Character->GetCameraProfile();
+    const int32 stepsAcross = FMath::CeilToInt((profile.CameraZoomMaximumDistance - profile.CameraZoomMinimumDistance) / profile.CameraZoomIncrement) + 2;
+
+    FExplorerInputTraceFrame zoomIn;
+    zoomIn.ActionMask = 1 << EExplorerInputTraceAction::ZoomIn;
+    FExplorerInputTraceFrame zoomOut;
+    zoomOut.ActionMask = 1 << EExplorerInputTraceAction::ZoomOut;
+
+    for (int32 Index = 0; Index < ARRAY_COUNT(AllCameraModes); Index++)
+    {
+        const FString modeName = GetNameForCameraMode(AllCameraModes[Index]);
+        if (!TestTrue(FString::Printf(TEXT("Switched to %s"), *modeName), testWorld.SwitchToCameraMode(AllCameraModes[Index]))) continue;
+
+        for (int32 Step = 0; Step < stepsAcross; Step++)
+        {
+            testWorld.Tick(zoomIn);
+        }
+        TestEqual(FString::Printf(TEXT("%s: zooming in stops at the minimum distance"), *modeName), testWorld.Character->GetCameraZoomCurrent(), profile.CameraZoomMinimumDistance);
+
+        for (int32 Step = 0; Step < stepsAcross; Step++)
+        {
+            testWorld.Tick(zoomOut);
+        }
+        TestEqual(FString::Printf(TEXT("%s: zooming out stops at the maximum distance"), *modeName), testWorld.Character->GetCameraZoomCurrent(), profile.CameraZoomMaximumDistance);
+        TestTrue(FString::Printf(TEXT("%s: arm length within the zoom range"), *modeName), testWorld.Character->GetCameraArmLength() <= profile.CameraZoomMaximumDistance);
+    }
+
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Follow Camera Reset
+#pragma mark - Follow Camera Reset
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExplorerCharacterAutoResetTest, "Explorer.Character.AutoReset", EAutomationTestFlags::ATF_Game)
+
+bool FExplorerCharacterAutoResetTest::RunTest(const FString& Parameters)
+{
+    using namespace ExplorerCharacterTest;
+
+    FTestWorld testWorld;
+    if (!testWorld.IsValid())
+    {
+        AddError(TEXT("Could not spawn a possessed AExplorerCharacter"));
+        return false;
+    }
+
+    const int32 failedChecks = FExplorerStats::GetNumFailedChecks();
+    const UExplorerCameraProfile& profile = testWorld.Character->GetCameraProfile();
+    if (!TestTrue(TEXT("Switched to the follow camera"), testWorld.SwitchToCameraMode(ECharacterCameraMode::ThirdPersonFollow))) return false;
+
+    // Walk for a moment so the idle timer starts over, let the character finish turning, then turn the camera away.
+    // The offset keeps the default AutoResetSpeed well inside Explorer.Check.MaxResetSeconds.
+    FExplorerInputTraceFrame walk;
+    walk.Axes[EExplorerInputTraceAxis::MoveForward] = 1.f;
+    for (int32 Frame = 0; Frame < 10; Frame++)
+    {
+        testWorld.Tick(walk);
+    }
+    testWorld.TickIdle(30);
+    testWorld.SetResetOffset(60.f);
+
+    const int32 idleFrames = FMath::CeilToInt(profile.AutoResetDelaySeconds / FrameSeconds);
+    for (int32 Frame = 0; Frame <= idleFrames && !testWorld.Character->IsCameraResetting(); Frame++)
+    {
+        testWorld.TickIdle(1);
+    }
+    if (!TestTrue(TEXT("The idle timer starts an automatic reset"), testWorld.Character->IsCameraAutoResetting())) return false;
+    TestTrue(FString::Printf(TEXT("The automatic reset waits for AutoResetDelaySeconds (started after %.2f seconds)"), testWorld.Character->GetInputIdleSeconds()),
+        testWorld.Character->GetInputIdleSeconds() >= profile.AutoResetDelaySeconds - FrameSeconds);
+
+    // The reset started this frame, so the first step has already been taken
+    const int32 expectedFrames = GetExpectedResetFrames(FMath::Abs(testWorld.GetResetOffset()), profile.AutoResetSpeed, testWorld.Character->CameraSimulationStepSeconds);
+    const int32 maxFrames = expectedFrames + expectedFrames / 10 + 10;
+    const int32 resetFrames = RunReset(*this, testWorld, maxFrames, TEXT("Automatic reset"));
+    TestTrue(FString::Printf(TEXT("Automatic reset converges within %d frames (took %d)"), maxFrames, resetFrames), resetFrames <= maxFrames);
+    TestTrue(TEXT("Automatic reset ends within the reset tolerance"), FMath::Abs(testWorld.GetResetOffset()) <= FExplorerFollowCameraParams().ResetToleranceDegrees + KINDA_SMALL_NUMBER);
+
+    TestEqual(TEXT("No runtime checks failed"), FExplorerStats::GetNumFailedChecks(), failedChecks);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExplorerCharacterResetDirectionTest, "Explorer.Character.ResetDirection", EAutomationTestFlags::ATF_Game)
+
+bool FExplorerCharacterResetDirectionTest::RunTest(const FString& Parameters)
+{
+    using namespace ExplorerCharacterTest;
+
+    FTestWorld testWorld;
+    if (!testWorld.IsValid())
+    {
+        AddError(TEXT("Could not spawn a possessed AExplorerCharacter"));
+        return false;
+    }
+
+    const int32 failedChecks = FExplorerStats::GetNumFailedChecks();
+    const UExplorerCameraProfile& profile = testWorld.Character->GetCameraProfile();
+    if (!TestTrue(TEXT("Switched to the follow camera"), testWorld.SwitchToCameraMode(ECharacterCameraMode::ThirdPersonFollow))) return false;
+
+    FExplorerInputTraceFrame reset;
+    reset.ActionMask = 1 << EExplorerInputTraceAction::ResetCamera;
+
+    // Either side of directly behind, where taking the long way round is easiest to get wrong
+    const float startOffsets[] = { 170.f, -170.f, 179.f, -179.f, 45.f };
+    for (int32 Index = 0; Index < ARRAY_COUNT(startOffsets); Index++)
+    {
+        const FString what = FString::Printf(TEXT("Manual reset from %.0f degrees"), startOffsets[Index]);
+
+        testWorld.SetResetOffset(startOffsets[Index]);
+        testWorld.Tick(reset);
+        if (!TestTrue(FString::Printf(TEXT("%s: starts"), *what), testWorld.Character->IsCameraResetting())) continue;
+
+        const int32 expectedFrames = GetExpectedResetFrames(FMath::Abs(testWorld.GetResetOffset()), profile.CameraResetSpeed, testWorld.Character->CameraSimulationStepSeconds);
+        const int32 maxFrames = expectedFrames + expectedFrames / 10 + 10;
+        const int32 resetFrames = RunReset(*this, testWorld, maxFrames, what);
+        TestTrue(FString::Printf(TEXT("%s: converges within %d frames (took %d)"), *what, maxFrames, resetFrames), resetFrames <= maxFrames);
+    }
+
+    TestEqual(TEXT("No runtime checks failed"), FExplorerStats::GetNumFailedChecks(), failedChecks);
+    return true;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Budgets
+#pragma mark - Budgets
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExplorerCharacterBudgetTest, "Explorer.Character.Budgets", EAutomationTestFlags::ATF_Game)
+
+bool FExplorerCharacterBudgetTest::RunTest(const FString& Parameters)
+{
+    using namespace ExplorerCharacterTest;
+
+    FTestWorld testWorld;
+    if (!testWorld.IsValid())
+    {
+        AddError(TEXT("Could not spawn a possessed AExplorerCharacter"));
+        return false;
+    }
+
+    // Budgets are checked when a CSV capture stops. This replaces any capture already running.
+    const int32 failedChecks = FExplorerStats::GetNumFailedChecks();
+    if (!TestTrue(TEXT("Started a CSV capture"), FExplorerStats::StartCsvCapture(FPaths::ProfilingDir() / TEXT("ExplorerCharacterBudgets.csv")))) return false;
+
+    // Every mode gets walking, turning, looking, zooming and a stretch of standing still
+    for (int32 Index = 0; Index < ARRAY_COUNT(AllCameraModes); Index++)
+    {
+        TestTrue(FString::Printf(TEXT("Switched to %s"), GetNameForCameraMode(AllCameraModes[Index])), testWorld.SwitchToCameraMode(AllCameraModes[Index]));
+
+        for (int32 Frame = 0; Frame < 240; Frame++)
+        {
+            FExplorerInputTraceFrame input;
+            input.Axes[EExplorerInputTraceAxis::MoveForward] = (Frame < 120) ? 1.f : -.5f;
+            input.Axes[EExplorerInputTraceAxis::MoveRight] = FMath::Sin(Frame * .05f);
+            input.Axes[EExplorerInputTraceAxis::Turn] = (Frame % 60 < 30) ? .5f : 0.f;
+            input.Axes[EExplorerInputTraceAxis::LookUpRate] = (Frame % 90 < 15) ? .25f : 0.f;
+            if (Frame % 40 == 0) input.ActionMask |= 1 << ((Frame % 80 == 0) ? EExplorerInputTraceAction::ZoomIn : EExplorerInputTraceAction::ZoomOut);
+            testWorld.Tick(input);
+        }
+
+        testWorld.TickIdle(60);
+    }
+
+    FExplorerStats::StopCsvCapture();
+    TestEqual(TEXT("Per-tick budgets met and no runtime checks failed"), FExplorerStats::GetNumFailedChecks(), failedChecks);
+    return true;
+}
+
+#endif // !UE_BUILD_SHIPPING
@@ -0,0 +1,122 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+#include "Explorer.h"
+#include "ExplorerPlayerInput.h"
+#include "Engine.h"
+
+#if !UE_BUILD_SHIPPING
+
+/**
+ Automation tests for FExplorerAxisIntegrator. No world is needed; the test plays the part of the player input and
+ the character, timestamping events and consuming the axis at a fixed 60 Hz.
+
+     UE4Editor <project> -game -nullrhi -unattended -ExecCmds="Automation RunTests Explorer.PlayerInput; Quit"
+ */
+
+namespace ExplorerPlayerInputTest
+{
+    static const float FrameSeconds = 1.f / 60.f;
+
+    /** One integrated axis with a stick mapped to it, consumed the way AExplorerCharacter::ConsumeRateAxisSeconds does */
+    class FTestAxis
+    {
+    public:
+        FTestAxis()
+            : Key(EKeys::Gamepad_RightX)
+            , FrameValue(0.f)
+            , FrameStartSeconds(100.0)
+        {
+            Integrator.Reset(TEXT("TurnRate"));
+            Integrator.AddKey(Key, 1.f);
+        }
+
+        /** Moves the stick at a fraction of the way through the current frame */
+        void SetValue(float Value, float FrameFraction)
+        {
+            Integrator.SetKeyValue(Key, Value, FrameStartSeconds + FrameFraction * FrameSeconds);
+            FrameValue = Value;
+        }
+
+        /** Ends the frame and returns what the character would turn by */
+        float Consume()
+        {
+            FrameStartSeconds += FrameSeconds;
+
+            float valueSeconds = 0.f;
+            if (!Integrator.Consume(FrameValue, FrameSeconds, FrameStartSeconds, valueSeconds))
+            {
+                valueSeconds = FrameValue * FrameSeconds;
+            }
+            return valueSeconds;
+        }
+
+    private:
+        FKey Key;
+        FExplorerAxisIntegrator Integrator;
+
+        /** What the input bindings see */
+        float FrameValue;
+
+        double FrameStartSeconds;
+    };
+}
+
+using namespace ExplorerPlayerInputTest;
+
+//////////////////////////////////////////////////////////////////////////
+// Step Input
+#pragma mark Step Input
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FExplorerAxisIntegratorStepTest, "Explorer.PlayerInput.StepInput", EAutomationTestFlags::ATF_Game)
+
+bool FExplorerAxisIntegratorStepTest::RunTest(const FString& Parameters)
+{
+    const float tolerance = 1e-5f;
+
+    // A step that arrives in one batch at the start of a frame counts for the whole of that frame, not the next one
+    {
+        FTestAxis axis;
+        TestEqual(TEXT("Batched step: nothing before the step"), axis.Consume(), 0.f, tolerance);
+
+        axis.SetValue(1.f, 0.f);
+        TestEqual(TEXT("Batched step: full value on the frame it arrives"), axis.Consume(), FrameSeconds, tolerance);
+        TestEqual(TEXT("Batched step: full value on the next frame"), axis.Consume(), FrameSeconds, tolerance);
+    }
+
+    // Events at distinct times within the frame hold each value for as long as it was current
+    {
+        FTestAxis axis;
+        axis.Consume();
+
+        axis.SetValue(.5f, .25f);
+        axis.SetValue(1.f, .5f);
+        TestEqual(TEXT("Timed step: integrated from the events"), axis.Consume(), (.25f * .5f + .5f) * FrameSeconds, tolerance);
+        TestEqual(TEXT("Timed step: full value on the next frame"), axis.Consume(), FrameSeconds, tolerance);
+
+        // Back down again: the value held before the first event covers the start of the frame
+        axis.SetValue(.4f, .3f);
+        axis.SetValue(0.f, .6f);
+        TestEqual(TEXT("Timed release: integrated from the events"), axis.Consume(), (.3f + .3f * .4f) * FrameSeconds, tolerance);
+        TestEqual(TEXT("Timed release: nothing on the next frame"), axis.Consume(), 0.f, tolerance);
+    }
+
+    // Over a run of frames the integral matches the input's, so the step is neither lost nor late
+    {
+        FTestAxis axis;
+        float total = 0.f;
+        for (int32 Frame = 0; Frame < 10; Frame++)
+        {
+            if (Frame == 3)
+            {
+                axis.SetValue(.5f, .2f);
+                axis.SetValue(1.f, .6f);
+            }
+            total += axis.Consume();
+        }
+        TestEqual(TEXT("Timed step: total over ten frames"), total, (.4f * .5f + .4f + 6.f) * FrameSeconds, tolerance);
+    }
+
+    return true;
+}
+
+#endif // !UE_BUILD_SHIPPING
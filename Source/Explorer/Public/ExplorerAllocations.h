@@ -0,0 +1,97 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+/**
+ Heap allocation tracking for the character's per-frame and per-input paths.
+
+ Every EXPLORER_SCOPE_CYCLE_COUNTER scope (the character's Tick, controller tick, axis and action handlers, camera
+ mode switches and the follow camera) also counts the game thread heap allocations made inside it while tracking is
+ on. Tracking routes GMalloc through a counting proxy, installed the first time tracking starts; until then nothing
+ is counted and a scope costs one branch.
+
+ After Explorer.Alloc.WarmUpFrames frames every frame is expected to be allocation free. Any frame that allocates is
+ logged as an error with a breakdown by scope. A headless check that drives every camera mode with the stress game
+ mode's scripted controllers:
+
+     MyMap?game=/Script/Explorer.ExplorerStressGameMode?StressCharacters=8?StressSeconds=60?StressExit -nullrhi -ExplorerAllocCheck
+
+ The run exits with a non-zero exit code if any frame allocated after the warm up.
+
+ Console: Explorer.Alloc.Start, Explorer.Alloc.Stop, Explorer.Alloc.Dump
+ */
+class FExplorerAllocations
+{
+public:
+    /** Starts counting, from a fresh warm up */
+    static void StartTracking();
+
+    /** Stops counting and logs the result */
+    static void StopTracking();
+
+    static bool IsTracking() { return bTracking; }
+
+    /** Ends the frame's count, checks it, and starts the next. Called once per frame. */
+    static void EndFrame();
+
+    /** Writes the counts so far to the log */
+    static void Dump();
+
+    /** Whether any frame after the warm up allocated */
+    static bool HasSteadyStateAllocations() { return NumAllocatingFrames > 0; }
+
+    /**
+     * Makes Stat the scope that game thread allocations are counted against.
+     * @param Stat	EExplorerCsvStat::Type, or INDEX_NONE to stop counting
+     * @return The previous scope, to hand back to LeaveScope
+     */
+    static int32 EnterScope(int32 Stat)
+    {
+        const int32 previous = CurrentScope;
+        CurrentScope = Stat;
+        return previous;
+    }
+
+    static void LeaveScope(int32 PreviousStat) { CurrentScope = PreviousStat; }
+
+private:
+    friend class FExplorerCountingMalloc;
+
+    /** Counts an allocation against the current scope, if it was made on the game thread inside one */
+    static void CountAllocation(SIZE_T Size);
+
+    static bool bTracking;
+    static int32 CurrentScope;
+    static int32 NumAllocatingFrames;
+};
+
+/** Counts allocations against a scope. Use through EXPLORER_SCOPE_CYCLE_COUNTER. */
+class FExplorerAllocationScope
+{
+public:
+    explicit FExplorerAllocationScope(int32 Stat)
+        : bActive(FExplorerAllocations::IsTracking())
+        , PreviousStat(bActive ? FExplorerAllocations::EnterScope(Stat) : INDEX_NONE)
+    {
+    }
+
+    ~FExplorerAllocationScope()
+    {
+        if (bActive) FExplorerAllocations::LeaveScope(PreviousStat);
+    }
+
+private:
+    bool bActive;
+    int32 PreviousStat;
+};
+
+/**
+ Stops counting for a scope, for engine calls that allocate in ways the character cannot avoid. Every use says why.
+ */
+class FExplorerAllocationExemption : public FExplorerAllocationScope
+{
+public:
+    FExplorerAllocationExemption()
+        : FExplorerAllocationScope(INDEX_NONE)
+    {
+    }
+};
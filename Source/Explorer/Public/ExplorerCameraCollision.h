@@ -0,0 +1,97 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+#include "Tickable.h"
+
+/**
+ Batched, asynchronous camera collision for AExplorerCharacter's spring arm.
+
+ The spring arm's own collision test is switched off. Instead, once per frame, every third person character a local
+ player looks through gets an async sweep from the arm's pivot to where its camera wants to be, all issued together
+ and run off the game thread with the rest of the frame's async traces. Results are used the frame after they come
+ back: the arm snaps in to the free length straight away and eases back out at CameraCollisionRecoverySpeed.
+
+ The character only ever sets the boom to its desired length clamped by ClampArmLength, so zooming out or blending
+ between camera modes can't carry the camera past what the last sweeps found free.
+
+ While the camera is swinging (the follow camera turning or resetting), a second sweep is aimed where the camera will
+ be CameraCollisionLookAheadSeconds from now, so the arm is already shortening by the time it reaches the geometry.
+ */
+
+class AExplorerCharacter;
+
+class FExplorerCameraCollision : public FTickableGameObject
+{
+public:
+    static FExplorerCameraCollision& Get();
+
+    /** Adds a character's camera boom to the batch. Characters drop out on their own once destroyed. */
+    void Register(AExplorerCharacter* Character);
+
+    /** Takes a character's camera boom out of the batch, e.g. when it goes into the pawn pool */
+    void Unregister(AExplorerCharacter* Character);
+
+    /**
+     * Limits an arm length to what the collision pass currently allows the character's camera.
+     * @return ArmLength, or the managed arm length if that is shorter
+     */
+    float ClampArmLength(const AExplorerCharacter& Character, float ArmLength) const;
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual bool IsTickable() const override { return Entries.Num() > FreeSlots.Num(); }
+    virtual TStatId GetStatId() const;
+
+private:
+    FExplorerCameraCollision();
+
+    enum EProbe
+    {
+        /** Toward the camera's current position */
+        CurrentProbe,
+
+        /** Toward where a swinging camera will be shortly */
+        PredictedProbe,
+
+        NumProbes
+    };
+
+    struct FEntry
+    {
+        TWeakObjectPtr<AExplorerCharacter> Character;
+
+        /** Whether the slot holds a character. Destroyed characters' slots are freed on the next tick. */
+        bool bInUse;
+
+        /** Bumped each time the slot is freed, so sweeps issued for a previous occupant are ignored */
+        uint32 Generation;
+
+        /** Arm length being applied, or negative when the arm is not being managed (first person, not local) */
+        float ArmLength;
+
+        /** Control yaw last frame, for estimating how fast the camera is swinging */
+        float PreviousYaw;
+
+        /** Unobstructed distance from the pivot found by the last completed sweep of each probe */
+        float FreeLength[NumProbes];
+
+        /** Built once per character, since the ignore list allocates */
+        FCollisionQueryParams QueryParams;
+    };
+
+    /** Applies last frame's results to one character and issues this frame's sweeps */
+    void UpdateEntry(FEntry& Entry, float DeltaTime);
+
+    /** Empties a slot for reuse */
+    void FreeSlot(int32 Slot);
+
+    /** Async sweep completion, called at the start of the following frame */
+    void OnSweepCompleted(const FTraceHandle& Handle, FTraceDatum& Datum);
+
+    /** Indexed by AExplorerCharacter::CameraCollisionSlot. Entries never move, so sweep results find theirs directly. */
+    TArray<FEntry> Entries;
+
+    /** Slots in Entries that are not in use */
+    TArray<int32> FreeSlots;
+
+    FTraceDelegate SweepDelegate;
+};
@@ -0,0 +1,163 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+/**
+ Camera mode policies and the registry that maps camera mode ids to them.
+
+ Each camera mode is a self contained policy with Enter, Exit and Update hooks. A character creates one instance of
+ each mode it uses (so a mode can keep per-character state) and dispatches to the active one through a single
+ virtual call. Modes that have no per-frame work return false from HasPerFrameWork() and are never updated.
+
+ Every mode describes its camera rig (arm length, first person meshes, controller yaw) once, when it is created. The
+ camera components stay attached as they are; switching modes only blends the arm length from the old rig to the new
+ one over the profile's CameraModeBlendSeconds, so a switch never reattaches or snaps components.
+
+ New modes register themselves from their own source file, without touching AExplorerCharacter:
+
+     class FMyOrbitCameraMode : public FExplorerCameraMode { ... };
+     EXPLORER_REGISTER_CAMERA_MODE(FMyOrbitCameraMode, MyOrbitModeId, TEXT("Orbit"), false);
+
+ Ids below ECharacterCameraMode::Max are the built in modes. Camera mode cycling visits registered modes in id order.
+ */
+
+class AExplorerCharacter;
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerCameraRig
+#pragma mark FExplorerCameraRig
+
+/** How a camera mode poses the character's camera components. Applied, and blended to, by the character. */
+struct FExplorerCameraRig
+{
+    /** Whether the arm is as long as the character's zoom distance. Otherwise it is ArmLength. */
+    bool bArmFollowsZoom;
+
+    /** Arm length when it does not follow the zoom */
+    float ArmLength;
+
+    /** Whether the owner sees the first person arms instead of the body. Switched at the end of a blend into the rig. */
+    bool bFirstPersonMeshes;
+
+    /** Whether the character turns with the controller's yaw. The character never pitches or rolls with it. */
+    bool bUseControllerRotationYaw;
+
+    FExplorerCameraRig()
+        : bArmFollowsZoom(true)
+        , ArmLength(0.f)
+        , bFirstPersonMeshes(false)
+        , bUseControllerRotationYaw(false)
+    {
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerCameraMode
+#pragma mark - FExplorerCameraMode
+
+/** Base class for camera mode policies */
+class FExplorerCameraMode
+{
+public:
+    virtual ~FExplorerCameraMode() {}
+
+    /** Called when the character switches into this mode, after the character has started blending to its rig */
+    virtual void Enter(AExplorerCharacter& Character) {}
+
+    /** Called when the character switches out of this mode */
+    virtual void Exit(AExplorerCharacter& Character) {}
+
+    /** Whether Update needs to be called at all. Queried once, on Enter. */
+    virtual bool HasPerFrameWork() const { return false; }
+
+    /**
+     * Per-frame hook. Only called for modes with per-frame work, and only while the character's controller tick
+     * is awake (there is movement input, or the mode asked to keep going).
+     * @param Character     The character being updated
+     * @param DeltaSeconds  Frame time
+     * @return true if the mode still has work to do next frame even without any input
+     */
+    virtual bool Update(AExplorerCharacter& Character, float DeltaSeconds) { return false; }
+
+    /** Whether the mode supports swinging the camera back behind the character */
+    virtual bool SupportsReset() const { return false; }
+
+    /** The mode's camera rig */
+    const FExplorerCameraRig& GetRig() const { return Rig; }
+
+protected:
+    /** Set up by the mode's constructor and left alone after that */
+    FExplorerCameraRig Rig;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Registry
+#pragma mark - Registry
+
+/** Static information about a registered camera mode */
+struct FExplorerCameraModeInfo
+{
+    /** Creates a new instance of the mode for a character */
+    typedef TSharedRef<FExplorerCameraMode> (*FFactory)();
+
+    FFactory Factory;
+    const TCHAR* DisplayName;
+    bool bFirstPerson;
+
+    FExplorerCameraModeInfo()
+        : Factory(NULL)
+        , DisplayName(NULL)
+        , bFirstPerson(false)
+    {
+    }
+};
+
+/** Maps camera mode ids to policies */
+class FExplorerCameraModeRegistry
+{
+public:
+    /** Largest number of camera modes that can be registered (ids are stored in a byte) */
+    static const int32 MaxModes = 256;
+
+    static FExplorerCameraModeRegistry& Get();
+
+    /**
+     * Registers a camera mode. Normally called through EXPLORER_REGISTER_CAMERA_MODE.
+     * @param ModeId        Id stored in AExplorerCharacter::CameraModeEnum
+     * @param Factory       Creates the per-character policy instance
+     * @param DisplayName   Name shown in debug output. Must have static lifetime.
+     * @param bFirstPerson  Whether movement is relative to the character (first person) or the camera (third person)
+     */
+    void Register(uint8 ModeId, FExplorerCameraModeInfo::FFactory Factory, const TCHAR* DisplayName, bool bFirstPerson);
+
+    /** Returns the mode registered for an id, or NULL */
+    const FExplorerCameraModeInfo* Find(uint8 ModeId) const
+    {
+        return (Modes[ModeId].Factory != NULL) ? &Modes[ModeId] : NULL;
+    }
+
+    /** Returns the registered mode that follows ModeId when cycling, wrapping around to the first */
+    uint8 GetNextMode(uint8 ModeId) const;
+
+private:
+    FExplorerCameraModeRegistry() {}
+
+    FExplorerCameraModeInfo Modes[MaxModes];
+};
+
+/** Registers a camera mode class when constructed. Declare one as a static in the mode's source file. */
+template<typename TMode>
+struct TExplorerCameraModeRegistrar
+{
+    TExplorerCameraModeRegistrar(uint8 ModeId, const TCHAR* DisplayName, bool bFirstPerson)
+    {
+        FExplorerCameraModeRegistry::Get().Register(ModeId, &Create, DisplayName, bFirstPerson);
+    }
+
+    static TSharedRef<FExplorerCameraMode> Create()
+    {
+        return MakeShareable(new TMode());
+    }
+};
+
+#define EXPLORER_REGISTER_CAMERA_MODE(ModeClass, ModeId, DisplayName, bFirstPerson) \
+    static TExplorerCameraModeRegistrar<ModeClass> ModeClass##Registrar((uint8)(ModeId), DisplayName, bFirstPerson);
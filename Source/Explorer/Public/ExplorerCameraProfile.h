@@ -0,0 +1,95 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+#include "Engine/DataAsset.h"
+#include "ExplorerFollowCameraSolver.h"
+#include "ExplorerCameraProfile.generated.h"
+
+/**
+ Camera tuning shared between AExplorerCharacters.
+
+ Characters reference a profile instead of each carrying their own copy of the tuning. Characters without one use the
+ class defaults, which are config properties and can be set in DefaultGame.ini under
+ [/Script/Explorer.ExplorerCameraProfile]. Profile assets can be edited while the game is running; characters pick
+ up the new values on their next frame.
+
+ When a profile is loaded or edited, the follow camera's turn angle response (the turn angle term raised to
+ CameraFollowTurnAngleExponent) is baked into a small lookup table, so the follow camera never calls pow.
+ */
+UCLASS(config=Game, BlueprintType)
+class UExplorerCameraProfile : public UDataAsset
+{
+    GENERATED_UCLASS_BODY()
+
+    /** Controls the follow camera turn angle. Only affects Third Person Follow mode. */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=SmoothFollowCamera)
+    float CameraFollowTurnAngleExponent;
+
+    /** Controls the follow camera turn speed. Only affects Third Person Follow mode */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=SmoothFollowCamera)
+    float CameraFollowTurnRate;
+
+    /** Controls the speed that the camera resets in Third Person Follow mode */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=SmoothFollowCamera)
+    float CameraResetSpeed;
+
+    /** Minimum distance for follow cameras */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=CameraZoom)
+    float CameraZoomMinimumDistance;
+
+    /** Maximum distance for follow cameras */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=CameraZoom)
+    float CameraZoomMaximumDistance;
+
+    /** Zoom increment for follow cameras */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=CameraZoom)
+    float CameraZoomIncrement;
+
+    /** Whether the smooth follow camera should be reset to behind character after being idle for a time */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=SmoothFollowCameraReset)
+    bool AutoResetSmoothFollowCameraWhenIdle;
+
+    /** The delay to use if using Auto Reset */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=SmoothFollowCameraReset)
+    float AutoResetDelaySeconds;
+
+    /** The speed to use for Auto Resets */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=SmoothFollowCameraReset)
+    float AutoResetSpeed;
+
+    /** How quickly the camera arm extends again once the obstruction is gone */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=CameraCollision)
+    float CameraCollisionRecoverySpeed;
+
+    /** How far ahead, in seconds, a swinging camera probes for geometry it is about to hit. Zero disables. */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=CameraCollision)
+    float CameraCollisionLookAheadSeconds;
+
+    /** How long a camera mode switch takes to blend from the old mode's camera rig to the new one. Zero snaps. */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=CameraModes)
+    float CameraModeBlendSeconds;
+
+    /** How far ahead, in seconds, the camera's predicted viewpoints are streamed in for. Zero disables. */
+    UPROPERTY(EditAnywhere, config, BlueprintReadOnly, Category=Streaming)
+    float StreamingPrefetchSeconds;
+
+    /** Follow camera solver tuning for this profile, using the baked turn response table */
+    FExplorerFollowCameraParams GetFollowParams() const;
+
+    /** Segments in the baked turn response table */
+    static const int32 TurnResponseTableSize = 128;
+
+    // UObject
+    virtual void PostInitProperties() override;
+    virtual void PostLoad() override;
+    virtual void PostReloadConfig(UProperty* PropertyThatWasLoaded) override;
+#if WITH_EDITOR
+    virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+protected:
+    /** Rebuilds the turn response table from CameraFollowTurnAngleExponent */
+    void Bake();
+
+    /** CameraFollowTurnAngleExponent applied to TurnResponseTableSize + 1 evenly spaced inputs from 0 to 1 */
+    float TurnResponseTable[TurnResponseTableSize + 1];
+};
@@ -0,0 +1,120 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+#include "ExplorerCameraReplication.generated.h"
+
+/**
+ Replicated camera state for AExplorerCharacter.
+
+ Camera mode, zoom and reset flags travel as one quantized struct (22 bits of payload). Property replication only
+ sends it to a connection when it differs from what that connection last received, and it skips the owning client,
+ which predicts its own changes and is only sent a correction when the server disagrees.
+
+ Every send and receive is counted per connection and per character; Explorer.NetStats prints the totals.
+ */
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerReplicatedCameraState
+#pragma mark FExplorerReplicatedCameraState
+
+USTRUCT()
+struct FExplorerReplicatedCameraState
+{
+    GENERATED_USTRUCT_BODY()
+
+    enum
+    {
+        /** Bits used for the zoom distance, which is quantized to whole units */
+        ZoomBits = 12,
+        MaxQuantizedZoom = (1 << ZoomBits) - 1,
+
+        FlagBits = 2,
+        ResettingFlag = 1 << 0,
+        AutoResetFlag = 1 << 1,
+
+        /** Total payload size */
+        NumBits = 8 + ZoomBits + FlagBits,
+    };
+
+    /** ECharacterCameraMode::Type, or the id of a registered custom mode */
+    UPROPERTY()
+    uint8 CameraMode;
+
+    /** CameraZoomCurrent, rounded to whole units */
+    UPROPERTY()
+    uint16 QuantizedZoom;
+
+    /** ResettingFlag | AutoResetFlag */
+    UPROPERTY()
+    uint8 Flags;
+
+    /** The character this state belongs to. Not replicated; only used to attribute bandwidth on the sending side. */
+    class AExplorerCharacter* OwnerCharacter;
+
+    FExplorerReplicatedCameraState()
+        : CameraMode(0)
+        , QuantizedZoom(0)
+        , Flags(0)
+        , OwnerCharacter(NULL)
+    {
+    }
+
+    /** Sets the replicated values, quantizing as it goes */
+    void SetState(uint8 InCameraMode, float Zoom, bool bResetting, bool bAutoReset)
+    {
+        CameraMode = InCameraMode;
+        QuantizedZoom = (uint16)FMath::Clamp((int32)(Zoom + .5f), 0, (int32)MaxQuantizedZoom);
+        Flags = (bResetting ? ResettingFlag : 0) | (bAutoReset ? AutoResetFlag : 0);
+    }
+
+    float GetZoom() const { return (float)QuantizedZoom; }
+    bool IsResetting() const { return (Flags & ResettingFlag) != 0; }
+    bool IsAutoReset() const { return (Flags & AutoResetFlag) != 0; }
+
+    bool operator==(const FExplorerReplicatedCameraState& Other) const
+    {
+        return CameraMode == Other.CameraMode && QuantizedZoom == Other.QuantizedZoom && Flags == Other.Flags;
+    }
+
+    bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FExplorerReplicatedCameraState> : public TStructOpsTypeTraitsBase
+{
+    enum
+    {
+        WithNetSerializer = true,
+        WithIdenticalViaEquality = true,
+    };
+};
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerNetStats
+#pragma mark - FExplorerNetStats
+
+/** Per-connection, per-character bandwidth counters for the character's camera replication */
+class FExplorerNetStats
+{
+public:
+    /**
+     * Counts replicated camera state or RPC data sent to a connection.
+     * @param Connection    Connection the data is going to
+     * @param Character     Character the data belongs to
+     * @param NumBits       Payload size
+     */
+    static void RecordSent(const class UNetConnection* Connection, const AActor* Character, int32 NumBits);
+
+    /**
+     * Counts camera state or RPC data received from a connection.
+     * @param Connection    Connection the data came from
+     * @param Character     Character the data belongs to
+     * @param NumBits       Payload size
+     */
+    static void RecordReceived(const class UNetConnection* Connection, const AActor* Character, int32 NumBits);
+
+    /** Writes the counters to the log */
+    static void Dump();
+
+    /** Clears all counters */
+    static void Reset();
+};
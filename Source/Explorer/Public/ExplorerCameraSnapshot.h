@@ -0,0 +1,130 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+/**
+ Camera state published by AExplorerCharacter for readers on other threads (audio, UI, telemetry).
+
+ The character publishes an immutable FExplorerCameraSnapshot whenever its camera state changes, and every frame in
+ which it is the view target, into a TExplorerPublishedValue. Take a reference to the buffer on the game thread:
+
+     TSharedRef<FExplorerCameraSnapshotBuffer, ESPMode::ThreadSafe> Buffer = Character->GetCameraSnapshotBuffer();
+
+ and read it from any thread, for as long as the reference is held (even after the character is destroyed):
+
+     FExplorerCameraSnapshot Snapshot;
+     if (Buffer->Read(Snapshot)) { ... }
+
+ Publishing never waits for readers and readers never take a lock. A read copies the newest complete snapshot and
+ checks afterwards that it was not overwritten during the copy, retrying in that (rare) case, so a snapshot is never
+ torn.
+ */
+
+//////////////////////////////////////////////////////////////////////////
+// TExplorerPublishedValue
+#pragma mark TExplorerPublishedValue
+
+/**
+ Single producer, multiple consumer published value. The producer writes each new value into the next of NumSlots
+ slots and then publishes its sequence number; readers copy the slot for the newest sequence number. A slot is only
+ reused NumSlots - 1 publishes later, which is what a reader checks for after copying.
+ */
+template<typename T, int32 NumSlots = 3>
+class TExplorerPublishedValue
+{
+public:
+    static_assert(NumSlots >= 3, "A reader needs at least one slot between the published and the one being written");
+
+    TExplorerPublishedValue()
+    {
+    }
+
+    /** Publishes a new value. Only ever called from one thread at a time (the game thread). */
+    void Publish(const T& Value)
+    {
+        const uint32 next = (uint32)Sequence.GetValue() + 1;
+        Slots[next % NumSlots] = Value;
+
+        // The slot has to be written before the sequence number says it can be read. Set is a full barrier.
+        Sequence.Set((int32)next);
+    }
+
+    /**
+     * Copies out the newest published value. Safe from any thread.
+     * @return false if nothing has been published yet
+     */
+    bool Read(T& OutValue) const
+    {
+        for (;;)
+        {
+            const uint32 sequence = (uint32)Sequence.GetValue();
+            if (sequence == 0) return false;
+
+            FPlatformMisc::MemoryBarrier();
+            OutValue = Slots[sequence % NumSlots];
+            FPlatformMisc::MemoryBarrier();
+
+            // The producer only starts overwriting this slot after publishing NumSlots - 1 more values
+            if ((uint32)Sequence.GetValue() - sequence < (uint32)(NumSlots - 1)) return true;
+        }
+    }
+
+    /** How many values have been published. Cheap to poll for changes. */
+    uint32 GetSequence() const { return (uint32)Sequence.GetValue(); }
+
+private:
+    T Slots[NumSlots];
+    FThreadSafeCounter Sequence;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerCameraSnapshot
+#pragma mark - FExplorerCameraSnapshot
+
+/** A character's camera state at one moment */
+struct FExplorerCameraSnapshot
+{
+    /** GFrameCounter when this was published */
+    uint64 FrameNumber;
+
+    /** FPlatformTime::Seconds() when this was published */
+    double PublishedSeconds;
+
+    /** The view, including the late camera update when it is on. Between view frames, the camera component's transform. */
+    FVector ViewLocation;
+    FRotator ViewRotation;
+
+    /** CameraZoomCurrent */
+    float Zoom;
+
+    /** Seconds without input, as of PublishedSeconds */
+    float IdleSeconds;
+
+    /** ECharacterCameraMode::Type, or a registered custom mode id */
+    uint8 CameraMode;
+
+    bool bFirstPerson;
+    bool bResetting;
+    bool bAutoReset;
+
+    FExplorerCameraSnapshot()
+        : FrameNumber(0)
+        , PublishedSeconds(0.0)
+        , ViewLocation(FVector::ZeroVector)
+        , ViewRotation(FRotator::ZeroRotator)
+        , Zoom(0.f)
+        , IdleSeconds(0.f)
+        , CameraMode(0)
+        , bFirstPerson(false)
+        , bResetting(false)
+        , bAutoReset(false)
+    {
+    }
+
+    /** Idle time extrapolated to now, assuming no input since this was published */
+    float GetIdleSecondsNow() const
+    {
+        return IdleSeconds + (float)(FPlatformTime::Seconds() - PublishedSeconds);
+    }
+};
+
+typedef TExplorerPublishedValue<FExplorerCameraSnapshot> FExplorerCameraSnapshotBuffer;
@@ -0,0 +1,75 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+/**
+ Opt-in camera smoothness telemetry for AExplorerCharacter.
+
+ While enabled, every view the character computes is recorded and differentiated: linear velocity, acceleration and
+ jerk of the camera position, and angular velocity, acceleration and jerk of its rotation. Frames above the
+ Explorer.Telemetry.* thresholds are flagged (and logged at Verbose). Camera mode switches record the orientation
+ error they leave the character with: any pitch or roll on the actor, and in first person any yaw between the actor
+ and the view. A blended switch is recorded when its rig blend ends, and its frames count towards the jitter figures
+ like any other camera move; only a snapped switch restarts the derivatives as a cut.
+
+ Results are summarized per camera mode for the session:
+
+     Explorer.Telemetry.Enable 1    Explorer.Telemetry.Dump    Explorer.Telemetry.Export [file]    Explorer.Telemetry.Reset
+
+ -ExplorerTelemetry on the command line enables it from the start, and -ExplorerTelemetry=<file> also exports the
+ summary as CSV when the game exits.
+ */
+class FExplorerCameraTelemetry
+{
+public:
+    FExplorerCameraTelemetry();
+
+    /** Whether telemetry is being recorded */
+    static bool IsEnabled();
+
+    /**
+     * Records one frame of the final view.
+     * @param CameraMode	The camera mode the view was computed in
+     * @param Location		View location
+     * @param Rotation		View rotation
+     * @param DeltaSeconds	Frame time
+     */
+    void AddFrame(uint8 CameraMode, const FVector& Location, const FRotator& Rotation, float DeltaSeconds);
+
+    /** Starts the derivatives over, so that a camera cut is not counted as jitter */
+    void Restart() { NumSamples = 0; }
+
+    /**
+     * Records the orientation error left by a camera mode switch.
+     * @param Character			For the log. Only named when the switch is flagged, so unflagged switches do not allocate.
+     * @param FromMode			The previous camera mode
+     * @param ToMode			The new camera mode
+     * @param ErrorDegrees		Largest of the actor's pitch and roll and, in first person, its yaw away from the view
+     */
+    static void RecordModeSwitch(const UObject* Character, uint8 FromMode, uint8 ToMode, float ErrorDegrees);
+
+    /** Writes the session summary to the log */
+    static void Dump();
+
+    /**
+     * Writes the session summary to a CSV file.
+     * @param Filename	The file to write. Defaults to a timestamped file in Saved/Profiling.
+     */
+    static bool Export(const FString& Filename);
+
+    /** Clears the session summary */
+    static void Reset();
+
+private:
+    /** Number of frames recorded since the last restart, up to the four needed for jerk */
+    int32 NumSamples;
+
+    FVector Location;
+    FVector Velocity;
+    FVector Acceleration;
+
+    FQuat Rotation;
+
+    /** Angular derivatives as axis * degrees per second (per second, per second squared) */
+    FVector AngularVelocity;
+    FVector AngularAcceleration;
+};
@@ -1,6 +1,16 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 #pragma once
 #include "GameFramework/Character.h"
+#include "ExplorerInputTrace.h"
+#include "ExplorerControllerTrace.h"
+#include "ExplorerCameraMode.h"
+#include "ExplorerCameraReplication.h"
+#include "ExplorerLookLatency.h"
+#include "ExplorerCameraTelemetry.h"
+#include "ExplorerStreamingPrefetch.h"
+#include "ExplorerCameraSnapshot.h"
+#include "ExplorerCameraProfile.h"
+#include "ExplorerSignificance.h"
 #include "ExplorerCharacter.generated.h"
 
 /**
@@ -31,30 +41,82 @@ namespace ECharacterCameraMode
 
 static inline bool IsFirstPerson(const ECharacterCameraMode::Type CameraMode)
 {
-    return (CameraMode == ECharacterCameraMode::FirstPerson);
+    const FExplorerCameraModeInfo* info = FExplorerCameraModeRegistry::Get().Find(CameraMode);
+    return (info != NULL) && info->bFirstPerson;
 }
 static inline bool IsThirdPerson(const ECharacterCameraMode::Type CameraMode)
 {
     return  !IsFirstPerson(CameraMode);
 }
-static inline FString GetNameForCameraMode(const ECharacterCameraMode::Type CameraMode)
+static inline const TCHAR* GetNameForCameraMode(const ECharacterCameraMode::Type CameraMode)
 {
-    switch(CameraMode)
+    const FExplorerCameraModeInfo* info = FExplorerCameraModeRegistry::Get().Find(CameraMode);
+    return (info != NULL) ? info->DisplayName : TEXT("Unknown Camera Mode");
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Movement Intent
+#pragma mark - Movement Intent
+
+/** Movement input for one frame, gathered from the axis bindings and resolved against the camera once */
+struct FExplorerMovementIntent
+{
+    /** "MoveForward" axis value */
+    float ForwardAxis;
+
+    /** "MoveRight" axis value */
+    float RightAxis;
+
+    /** World direction for forward input. Only valid when HasMovement() is true. */
+    FVector ForwardDirection;
+
+    /** World direction for right input. Only valid when HasMovement() is true. */
+    FVector RightDirection;
+
+    FExplorerMovementIntent()
+        : ForwardAxis(0.f)
+        , RightAxis(0.f)
+        , ForwardDirection(FVector::ZeroVector)
+        , RightDirection(FVector::ZeroVector)
     {
-        case ECharacterCameraMode::ThirdPersonDefault:
-            return TEXT("Third Person (Default UE4)");
-            break;
-        case ECharacterCameraMode::FirstPerson:
-            return TEXT("First Person");
-            break;
-        case ECharacterCameraMode::ThirdPersonFollow:
-            return TEXT("Third Person Follow");
-            break;
-        default:
-            return TEXT("Unknown Camera Mode");
     }
-    return NULL;
-}
+
+    bool HasMovement() const { return ForwardAxis != 0.f || RightAxis != 0.f; }
+};
+
+
+//////////////////////////////////////////////////////////////////////////
+// Controller Tick Function
+#pragma mark - Controller Tick Function
+
+/**
+ Tick function for the character's movement and camera work, kept separate from the actor's primary tick so that it
+ can be switched off whenever there is nothing to do.
+ */
+struct FExplorerControllerTickFunction : public FTickFunction
+{
+    /** The character to tick */
+    class AExplorerCharacter* Target;
+
+    /**
+     * Minimum seconds between camera updates. Movement input is applied on every tick, since the movement component
+     * ticks every frame regardless; skipped camera time is folded into the next camera update.
+     */
+    float Interval;
+
+    /** Time since the last camera update, while Interval is set */
+    float SkippedSeconds;
+
+    FExplorerControllerTickFunction()
+        : Target(NULL)
+        , Interval(0.f)
+        , SkippedSeconds(0.f)
+    {
+    }
+
+    virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+    virtual FString DiagnosticMessage() override;
+};
 
 #pragma mark - AExplorerCharacter
 
@@ -75,6 +137,14 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
 	TSubobjectPtr<class UCameraComponent> FollowCamera;
 
+    /** Arms-only mesh seen by the owner in first person. Attached to the camera; assign the mesh in a Blueprint subclass. */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Mesh)
+    TSubobjectPtr<class USkeletalMeshComponent> FirstPersonMesh;
+
+    /** Whether the third person mesh stays on as a shadow caster (with throttled animation) while the owner is in first person */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Mesh)
+    bool FirstPersonBodyCastsShadow;
+
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
 	float BaseTurnRate;
@@ -87,41 +157,34 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Camera)
     TEnumAsByte<ECharacterCameraMode::Type> CameraModeEnum;
 
-    /** Controls the follow camera turn angle. Only affects Third Person Follow mode. */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=SmoothFollowCamera)
-    float CameraFollowTurnAngleExponent;
-
-    /** Controls the follow camera turn speed. Only affects Third Person Follow mode */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=SmoothFollowCamera)
-    float CameraFollowTurnRate;
-
-    /** Controls the speed that the camera resets in Third Person Follow mode */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=SmoothFollowCamera)
-    float CameraResetSpeed;
-
-    /** Minimum distance for follow cameras */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraZoom)
-    float CameraZoomMinimumDistance;
-
-    /** Minimum distance for follow cameras */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraZoom)
-    float CameraZoomMaximumDistance;
+    /** Camera tuning, shared with other characters. Characters without a profile use the UExplorerCameraProfile defaults. */
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category=Camera)
+    class UExplorerCameraProfile* CameraProfile;
 
-    /** Zoom increment for follow cameras */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraZoom)
-    float CameraZoomIncrement;
+    /** Fixed time step for the follow camera simulation, in seconds. Independent of the frame rate; the view is interpolated between steps. */
+    UPROPERTY(EditAnywhere, config, Category=ControllerTick)
+    float CameraSimulationStepSeconds;
 
-    /** Whether the smooth follow camera should be reset to behind character after being idle for a time */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=SmoothFollowCameraReset)
-    bool AutoResetSmoothFollowCameraWhenIdle;
+    /**
+     * Minimum time between camera updates, in seconds. Zero updates every frame. Movement input is still applied every
+     * frame. Skipped frames are folded into the next camera update, which the fixed step camera simulation catches up
+     * on. Takes effect when the tick function is registered.
+     */
+    UPROPERTY(EditAnywhere, config, Category=ControllerTick)
+    float ControllerTickInterval;
 
-    /** The delay to use if using Auto Reset */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=SmoothFollowCameraReset)
-    float AutoResetDelaySeconds;
+    /** Tick group the movement and camera update runs in. Takes effect when the tick function is registered. */
+    UPROPERTY(EditAnywhere, config, Category=ControllerTick)
+    TEnumAsByte<enum ETickingGroup> ControllerTickGroup;
 
-    /** The speed to use for Auto Resets */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=SmoothFollowCameraReset)
-    float AutoResetSpeed;
+    /**
+     * Re-applies the newest control rotation to the view just before it goes to the renderer, instead of waiting for the
+     * camera boom to pick it up on its next component tick. Skipped while the boom has rotation lag. Overridden by the
+     * Explorer.Camera.LateUpdate console variable. The first person arms mesh is not moved, so it trails the view by
+     * the late correction.
+     */
+    UPROPERTY(EditAnywhere, config, Category=Camera)
+    bool LateUpdateCameraRotation;
 
     //////////////////////////////////////////////////////////////////////////
     // Protected Attributes
@@ -135,14 +198,107 @@ protected:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraInternal)
     float CameraZoomCurrent;
 
-    /** Keeps track of when the last movement was */
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraInternal)
+    /** Keeps track of when the last movement was, in world seconds */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=CameraInternal)
     float LastMovementTime;
 
+    /** Whether the idle timer has expired without any input since */
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=CameraInternal)
+    bool IsIdle;
+
     /** Keeps track of whether a reset is automatic or manual */
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=CameraInternal)
     bool IsAutoReset;
 
+    /** Tick function for movement and the follow camera. Only enabled while there is movement input or a reset. */
+    FExplorerControllerTickFunction ControllerTick;
+
+    /** "MoveForward" value received this frame, not yet applied */
+    float PendingForwardAxis;
+
+    /** "MoveRight" value received this frame, not yet applied */
+    float PendingRightAxis;
+
+    /** This frame's movement input, shared by AddMovementInput and the follow camera */
+    FExplorerMovementIntent MovementIntent;
+
+    /** Per-character camera mode policy instances, indexed by mode id and created in BeginPlay */
+    TArray<TSharedPtr<FExplorerCameraMode> > CameraModeInstances;
+
+    /** Policy for CameraModeEnum */
+    FExplorerCameraMode* ActiveCameraMode;
+
+    /** Cached from the active mode on Enter, so the per-frame path does not have to ask */
+    bool ActiveCameraModeHasPerFrameWork;
+    bool ActiveCameraModeIsFirstPerson;
+
+    /** Arm length when the current camera rig blend started */
+    float CameraRigBlendFromArmLength;
+
+    /** Actor yaw when the current camera rig blend started. A rig that turns the body with the controller turns it from here. */
+    float CameraRigBlendFromYaw;
+
+    /** Whether a camera mode switch is waiting for its rig blend to end before its orientation error is recorded */
+    bool CameraModeSwitchPendingTelemetry;
+
+    /** The mode that switch came from */
+    uint8 CameraModeSwitchFromMode;
+
+    /** Time into the current camera rig blend */
+    float CameraRigBlendSeconds;
+
+    /** Length of the current camera rig blend. Zero when the arm is not blending. */
+    float CameraRigBlendDuration;
+
+    /** Camera mode, zoom and reset flags for other clients. Not replicated to the owner, which predicts its own. */
+    UPROPERTY(ReplicatedUsing=OnRep_ReplicatedCameraState)
+    FExplorerReplicatedCameraState ReplicatedCameraState;
+
+    /** The last state the owning client sent to the server, so that unchanged state is never sent twice */
+    FExplorerReplicatedCameraState LastSentCameraState;
+
+    /** Set while replicated state is being applied, so applying it does not send it straight back */
+    bool IsApplyingCameraState;
+
+    /** Look input to view latency, measured when this character is the view target */
+    FExplorerLookLatency LookLatency;
+
+    /** Camera smoothness, recorded when this character is the view target and telemetry is enabled */
+    FExplorerCameraTelemetry CameraTelemetry;
+
+    /** Streams in where the camera is heading, when this character is the view target */
+    FExplorerStreamingPrefetch StreamingPrefetch;
+
+    /** Camera state for readers on other threads. Shared so that readers can outlive the character. */
+    TSharedPtr<FExplorerCameraSnapshotBuffer, ESPMode::ThreadSafe> CameraSnapshotBuffer;
+
+    /** Minimum time between camera updates, set by FExplorerSignificance. Zero updates every frame. */
+    float SignificanceTickInterval;
+
+    /** This character's entry in FExplorerCameraCollision, or INDEX_NONE */
+    int32 CameraCollisionSlot;
+
+    /** FExplorerStats::ECharacterCount flags this character is currently counted under */
+    uint8 StatCounts;
+
+    /** Input trace being recorded, if any */
+    TSharedPtr<FExplorerInputTraceWriter> InputTraceWriter;
+
+    /** Input trace being replayed, if any */
+    TSharedPtr<FExplorerInputTraceReader> InputTraceReader;
+
+    /** The replayed frame currently being applied */
+    FExplorerInputTraceFrame InputReplayFrame;
+
+    /** Wall clock time when the current replay started, for benchmark reporting */
+    double InputReplayStartTime;
+
+    /** Engine fixed time step settings to restore when a replay ends */
+    bool InputReplayWasBenchmarking;
+    double InputReplayPreviousFixedDeltaTime;
+
+    /** Whether the character is dormant in AExplorerGameMode's pawn pool */
+    bool InPawnPool;
 
 
 
@@ -167,9 +323,62 @@ protected:
     /** Handler for reset camera button */
     void ResetCamera();
 
-    /** Handles setting of properties based on camera mode value */
+    /** Switches to the camera mode policy for CameraModeEnum, running the old mode's Exit and the new mode's Enter */
     void UpdateForCameraMode();
 
+    /** Returns this character's instance of a camera mode policy, or NULL if the mode is not registered */
+    FExplorerCameraMode* FindOrCreateCameraMode(uint8 ModeId);
+
+    /** Whether the camera is blending from the previous camera mode's rig to the current one */
+    bool IsCameraRigBlending() const { return CameraRigBlendDuration > 0.f; }
+
+    /** How far through the camera rig blend the rig is, eased at both ends. One when not blending. */
+    float GetCameraRigBlendAlpha() const;
+
+    /** Sets the camera boom to GetCameraArmLength(), no further out than camera collision allows */
+    void ApplyCameraArmLength();
+
+    /** While blending into a rig that turns the body with the controller, turns the body part way to the control yaw */
+    void ApplyCameraRigBlendYaw();
+
+    /**
+     * Advances the camera rig blend. Called by the controller tick while a blend is running.
+     * @return true while the blend has further to go
+     */
+    bool UpdateCameraRigBlend(float DeltaSeconds);
+
+    /** How far the character is from upright after a mode switch, and in first person how far it faces away from the view */
+    float GetCameraModeOrientationError() const;
+
+    /** Updates the follow / resetting / first person character counts shown by "stat Explorer" */
+    void UpdateStatCounts();
+
+public:
+    /**
+     * Shows, hides and throttles the first and third person meshes. Called when the camera rig changes.
+     * @param bFirstPerson	Whether the owner is looking through a first person camera
+     */
+    void UpdateMeshesForCameraMode(bool bFirstPerson);
+
+    /**
+     * Sets the significance detail level's part of the mesh settings. Called by FExplorerSignificance, which also
+     * throttles the camera with SetSignificanceTickInterval.
+     */
+    void SetSignificanceLevel(EExplorerSignificance::Type Level);
+
+protected:
+    /** Applies the mesh visibility, shadow and animation settings that follow from both the camera mode and the significance level */
+    void RefreshMeshSettings();
+
+    /** Whether the meshes are set up for the owner looking through a first person camera */
+    bool MeshesInFirstPerson;
+
+    /** Detail level last set by FExplorerSignificance */
+    EExplorerSignificance::Type SignificanceLevel;
+
+    /** The body mesh's CastShadow as set up in the class defaults, before camera modes or significance changed it */
+    bool MeshCastsShadowByDefault;
+
     /**
      * Whether the current camera mode is a first person mode.
      */
@@ -181,6 +390,53 @@ protected:
     bool IsInThirdPersonMode();
 
 
+public:
+    /** The camera tuning in use: CameraProfile, or the defaults if there is none */
+    const UExplorerCameraProfile& GetCameraProfile() const
+    {
+        return (CameraProfile != NULL) ? *CameraProfile : *GetDefault<UExplorerCameraProfile>();
+    }
+
+    /** The current zoom distance for third person cameras */
+    float GetCameraZoomCurrent() const { return CameraZoomCurrent; }
+
+    /** The arm length the active camera rig wants, part way between the old and new rig while a mode switch blends */
+    float GetCameraArmLength() const;
+
+    /** Whether the camera is swinging back to behind the character */
+    bool IsCameraResetting() const { return IsResetting; }
+
+    /** Whether the current reset was started by the idle timer */
+    bool IsCameraAutoResetting() const { return IsAutoReset; }
+
+    /**
+     * Starts swinging the camera back to behind the character, if the active camera mode supports it.
+     * @param bAutomatic	Whether this is an idle reset (uses AutoResetSpeed, and only if auto reset is enabled)
+     */
+    void RequestCameraReset(bool bAutomatic);
+
+    /** Stops any camera reset in progress */
+    void CancelCameraReset();
+
+    /** This frame's movement input */
+    const FExplorerMovementIntent& GetMovementIntent() const { return MovementIntent; }
+
+    /** The buffer this character publishes its camera state to. Hold on to the reference to read it from any thread. */
+    TSharedRef<FExplorerCameraSnapshotBuffer, ESPMode::ThreadSafe> GetCameraSnapshotBuffer() const { return CameraSnapshotBuffer.ToSharedRef(); }
+
+protected:
+    /**
+     * Publishes the current camera state to CameraSnapshotBuffer.
+     * @param ViewLocation	The view location to publish
+     * @param ViewRotation	The view rotation to publish
+     */
+    void PublishCameraSnapshot(const FVector& ViewLocation, const FRotator& ViewRotation);
+
+    /** Publishes the current camera state, with the camera component's transform as the view */
+    void PublishCameraSnapshot();
+
+protected:
+
     //////////////////////////////////////////////////////////////////////////
     // Camera Zoom
 #pragma mark Camera Zoom
@@ -212,6 +468,15 @@ protected:
 	 */
 	void LookUpAtRate(float Rate);
 
+    /**
+     * How far a rate axis has moved since it was last consumed, integrated over the time each input value was current
+     * when the player input supports that, or this frame's value times the frame time when it does not.
+     * @param AxisName	The axis mapping name
+     * @param Rate		This frame's value from the input binding
+     * @return Rate times seconds
+     */
+    float ConsumeRateAxisSeconds(FName AxisName, float Rate);
+
 	/** Called for forwards/backward input */
 	void MoveForward(float Value);
 
@@ -224,9 +489,93 @@ protected:
 	 */
     void HandleYawInput(float turnInput);
 
+    /**
+	 * Handles the LookUp Axis. Just passes on to &APawn::AddControllerPitchInput, but the value is captured for input traces.
+	 * @param lookUpInput	The "LookUp" axis value
+	 */
+    void HandlePitchInput(float lookUpInput);
+
     /** Handles jump. Just passes on to &ACharacter::Jump, but time is tracked for Camera Auto Reset */
     void HandleJump();
 
+    //////////////////////////////////////////////////////////////////////////
+    // Idle Tracking
+#pragma mark Idle Tracking
+
+public:
+    /** Whether there has been no input for AutoResetDelaySeconds */
+    UFUNCTION(BlueprintPure, Category=SmoothFollowCameraReset)
+    bool IsInputIdle() const;
+
+    /** Seconds since the last input activity */
+    UFUNCTION(BlueprintPure, Category=SmoothFollowCameraReset)
+    float GetInputIdleSeconds() const;
+
+protected:
+    /**
+     * Called by the input handlers whenever there is input. Marks the character as active and re-arms the
+     * idle timer if it had already expired.
+     */
+    void NoteInputActivity();
+
+    /** (Re)starts the idle timer */
+    void ArmIdleTimer(float Seconds);
+
+    /** Idle timer callback. Fires the auto reset once, or re-arms if there was input since the timer was set. */
+    void OnIdleTimerExpired();
+
+
+
+    //////////////////////////////////////////////////////////////////////////
+    // Tick Scheduling
+#pragma mark Tick Scheduling
+
+    friend struct FExplorerControllerTickFunction;
+    friend class FExplorerCameraCollision;
+
+    /** Enables the controller tick. It disables itself again once it has nothing to do. */
+    void WakeControllerTick();
+
+    /** Disables the controller tick until the next input or reset */
+    void SleepControllerTick();
+
+    /** Applies the larger of ControllerTickInterval and SignificanceTickInterval to the controller tick */
+    void UpdateControllerTickInterval();
+
+    /**
+     * Makes the controller tick depend on NewController's primary tick (which processes input), replacing any previous
+     * controller's. Called on the server from PossessedBy and on the owning client once the controller replicates.
+     */
+    void SetControllerTickPrerequisite(AController* NewController);
+
+    /** The controller the controller tick currently depends on */
+    TWeakObjectPtr<AController> ControllerTickPrerequisite;
+
+public:
+    /**
+     * Throttles the camera mode and rig blend updates on top of ControllerTickInterval. Movement input is still applied
+     * every frame. Skipped frames are folded into the DeltaSeconds of the next camera update.
+     * @param Interval	Minimum seconds between camera updates. Zero updates every frame.
+     */
+    void SetSignificanceTickInterval(float Interval);
+
+protected:
+
+    /** Enables the primary actor tick only while something needs it */
+    void UpdatePrimaryTickEnabled();
+
+    /**
+     * Called by the controller tick function. Applies this frame's movement intent and updates the follow camera.
+     * @param DeltaSeconds			Frame time
+     * @param CameraDeltaSeconds	Time since the last camera update, or zero when the camera update is throttled this frame
+     */
+    void TickController(float DeltaSeconds, float CameraDeltaSeconds);
+
+    /** Collects the axis values received this frame into MovementIntent and resolves the movement basis once */
+    void GatherMovementIntent();
+
+
+
     //////////////////////////////////////////////////////////////////////////
     // Touch Input
 #pragma mark Touch Input
@@ -235,18 +584,165 @@ protected:
 	void TouchStarted(ETouchIndex::Type FingerIndex, FVector Location);
 
 
+    //////////////////////////////////////////////////////////////////////////
+    // Input Trace
+#pragma mark Input Trace
+
+public:
+    /**
+     * Starts recording everything the input bindings receive to a binary trace.
+     * @param Filename	The trace file. Defaults to a timestamped file in Saved/InputTraces.
+     */
+    UFUNCTION(exec)
+    void RecordInputTrace(const FString& Filename);
+
+    /** Stops recording or replaying an input trace */
+    UFUNCTION(exec)
+    void StopInputTrace();
+
+    /**
+     * Replays a recorded input trace in place of live input, with the engine locked to the recorded frame times.
+     * @param Filename	The trace file to replay
+     */
+    UFUNCTION(exec)
+    void ReplayInputTrace(const FString& Filename);
+
+    /** Whether an input trace is currently being replayed */
+    bool IsReplayingInputTrace() const { return InputTraceReader.IsValid(); }
+
+    /**
+     * Feeds one frame of input through the input handlers, exactly as if it had come from the input bindings.
+     * Used by input trace replays and by scripted controllers.
+     * @param Frame	The axis values and actions for this frame
+     */
+    void ApplyInputFrame(const FExplorerInputTraceFrame& Frame);
+
+protected:
+    /** Captures an axis value for the input trace being recorded */
+    void RecordInputAxis(EExplorerInputTraceAxis::Type Axis, float Value)
+    {
+        if (InputTraceWriter.IsValid()) InputTraceWriter->RecordAxis(Axis, Value);
+    }
+
+    /** Captures an action for the input trace being recorded */
+    void RecordInputAction(EExplorerInputTraceAction::Type Action)
+    {
+        if (InputTraceWriter.IsValid()) InputTraceWriter->RecordAction(Action);
+    }
+
+    /** Feeds the next replayed frame through the input handlers. Called at the start of Tick. */
+    void ApplyInputReplayFrame();
+
+    /** Ends the current replay, restoring live input and the engine time step */
+    void FinishInputReplay();
+
+
+    //////////////////////////////////////////////////////////////////////////
+    // Pawn Pool
+#pragma mark Pawn Pool
+
+public:
+    /**
+     * Makes the character dormant for AExplorerGameMode's pawn pool: hidden, without collision, nothing ticking, its
+     * camera shut down, and out of the significance ranking and camera collision batch. It has to be unpossessed first.
+     */
+    void EnterPawnPool();
+
+    /**
+     * Brings a pooled character back into play with the camera mode and zoom a new character would have.
+     * @param Location	Where to place it
+     * @param Rotation	Which way it faces
+     */
+    void LeavePawnPool(const FVector& Location, const FRotator& Rotation);
+
+    /** Whether the character is dormant in the pawn pool */
+    bool IsInPawnPool() const { return InPawnPool; }
+
+protected:
+    /** Starts the camera, idle timer and per-frame systems. Run by BeginPlay, or on leaving the pool. */
+    void StartPlaying();
+
+    /** Shows or hides the character and switches its collision, ticking and replication on or off */
+    void SetPooledComponentsActive(bool bActive);
+
+
+    //////////////////////////////////////////////////////////////////////////
+    // Replication
+#pragma mark Replication
+
+    /**
+     * Publishes the current camera state. On the server this updates ReplicatedCameraState; on the owning client
+     * the locally predicted state is sent to the server if it changed.
+     */
+    void SyncCameraState();
+
+    /** Applies a camera state received from the server */
+    void ApplyCameraState(const FExplorerReplicatedCameraState& State);
+
+    UFUNCTION()
+    void OnRep_ReplicatedCameraState();
+
+    /** Sends the owning client's camera state to the server */
+    UFUNCTION(Server, Reliable, WithValidation)
+    void ServerSetCameraState(FExplorerReplicatedCameraState State);
+    bool ServerSetCameraState_Validate(FExplorerReplicatedCameraState State);
+    void ServerSetCameraState_Implementation(FExplorerReplicatedCameraState State);
+
+    /** Overrides the owning client's prediction when the server did not accept it as sent */
+    UFUNCTION(Client, Reliable)
+    void ClientCorrectCameraState(FExplorerReplicatedCameraState State);
+    void ClientCorrectCameraState_Implementation(FExplorerReplicatedCameraState State);
+
+
     //////////////////////////////////////////////////////////////////////////
     // APawn Overrides
 #pragma mark APawn Overrides
 
 	virtual void SetupPlayerInputComponent(class UInputComponent* InputComponent) override;
 
+    virtual void PossessedBy(AController* NewController) override;
+
+    virtual void UnPossessed() override;
+
+    virtual void PawnClientRestart() override;
+
+    virtual void OnRep_Controller() override;
+
+    /** Player controllers turn yaw input into rotation themselves; for other controllers it is applied here */
+    virtual void AddControllerYawInput(float Val) override;
+
+    /** Player controllers turn pitch input into rotation themselves; for other controllers it is applied here */
+    virtual void AddControllerPitchInput(float Val) override;
+
 
     //////////////////////////////////////////////////////////////////////////
     // AActor Overrides
 #pragma mark AActor Overrides
 
+    virtual void PostInitializeComponents() override;
+
+    virtual void BeginPlay() override;
+
+    virtual void RegisterActorTickFunctions(bool bRegister) override;
+
     virtual void Tick(float DeltaSeconds);
 
+    /**
+     * Applies the late camera update, if enabled, measures look input latency and camera smoothness, and prefetches
+     * streaming for where the camera is heading
+     */
+    virtual void CalcCamera(float DeltaTime, struct FMinimalViewInfo& OutResult) override;
+
+    virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+    virtual void Destroyed() override;
+
+
+    //////////////////////////////////////////////////////////////////////////
+    // UObject Overrides
+#pragma mark UObject Overrides
+
+    virtual void BeginDestroy() override;
+
 };
 
@@ -0,0 +1,95 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+/**
+ Structured trace channel for character controller events (camera mode changes, resets, zoom...).
+
+ Events are written as fixed size records into a lock-free ring buffer, so recording one costs a handful of stores
+ and never allocates. The buffer can be dumped with the Explorer.DumpControllerTrace console command, and the
+ Explorer.Trace.OnScreen / Explorer.Trace.Log console variables echo events as they happen (those sinks do format
+ strings, so they are off by default).
+
+ The whole channel compiles out of Shipping builds. Use EXPLORER_TRACE_EVENT rather than calling
+ FExplorerControllerTrace directly so that call sites disappear with it.
+ */
+
+#define EXPLORER_CONTROLLER_TRACE (!UE_BUILD_SHIPPING)
+
+//////////////////////////////////////////////////////////////////////////
+// Controller Events
+#pragma mark Controller Events
+
+namespace EExplorerControllerEvent
+{
+    enum Type
+    {
+        CycleCameraRequested,
+        CameraModeChanged,
+        ResetCameraRequested,
+        ResetFinished,
+        IdleTimerExpired,
+        ZoomCameraIn,
+        ZoomCameraOut,
+
+        Max,
+    };
+}
+
+#if EXPLORER_CONTROLLER_TRACE
+
+/** One traced event */
+struct FExplorerControllerTraceRecord
+{
+    /** FPlatformTime::Seconds() when the event was recorded */
+    double Time;
+
+    /** GFrameCounter when the event was recorded */
+    uint64 Frame;
+
+    /** Name of the character that raised the event */
+    FName ActorName;
+
+    /** EExplorerControllerEvent::Type */
+    uint8 Event;
+
+    /** ECharacterCameraMode::Type at the time of the event */
+    uint8 CameraMode;
+
+    /** Event specific payload, e.g. the new zoom distance */
+    float Value;
+};
+
+/** Process wide ring buffer of controller events */
+class FExplorerControllerTrace
+{
+public:
+    /** Number of records kept. Must be a power of two. */
+    static const int32 Capacity = 1024;
+
+    /**
+     * Records an event. Safe to call from any thread.
+     * @param Source        The object that raised the event
+     * @param Event         What happened
+     * @param CameraMode    The camera mode at the time
+     * @param Value         Event specific payload
+     */
+    static void Record(const UObject* Source, EExplorerControllerEvent::Type Event, uint8 CameraMode, float Value);
+
+    /**
+     * Copies the most recent records out of the buffer, oldest first. Records being written concurrently are skipped.
+     * @param OutRecords    Receives the records
+     * @param MaxRecords    Maximum number of records to return
+     */
+    static void GetRecentRecords(TArray<FExplorerControllerTraceRecord>& OutRecords, int32 MaxRecords = Capacity);
+
+    /** Display name for an event */
+    static const TCHAR* GetEventName(EExplorerControllerEvent::Type Event);
+};
+
+#define EXPLORER_TRACE_EVENT(Source, Event, CameraMode, Value) FExplorerControllerTrace::Record((Source), EExplorerControllerEvent::Event, (uint8)(CameraMode), (float)(Value))
+
+#else
+
+#define EXPLORER_TRACE_EVENT(Source, Event, CameraMode, Value)
+
+#endif // EXPLORER_CONTROLLER_TRACE
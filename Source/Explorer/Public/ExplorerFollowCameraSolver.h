@@ -0,0 +1,402 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+/**
+ Batched smooth follow / reset camera solver.
+
+ This is the math that used to live inline in AExplorerCharacter::Tick, pulled out so it can be run for any number
+ of cameras at once (spectator and replay views) and so it can be built and exercised without the engine. It has
+ no UObject or engine dependencies - only the C++ standard library and, where available, SSE2 intrinsics.
+
+ Camera state is passed in structure-of-arrays form. Each call advances every camera in the batch by one frame and
+ writes the yaw input that the owning controller should apply (the value that used to be handed to
+ AddControllerYawInput). Cameras are processed four at a time on the SSE2 path, with the remainder handled by the
+ scalar path.
+
+ All angles are in degrees, matching FRotator.
+ */
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define EXPLORER_FOLLOW_SOLVER_SSE 1
+#else
+#define EXPLORER_FOLLOW_SOLVER_SSE 0
+#endif
+
+//////////////////////////////////////////////////////////////////////////
+// Solver Types
+#pragma mark Solver Types
+
+/** Per-camera state flags, stored in FExplorerFollowCameraBatch::Flags */
+namespace EExplorerFollowCameraFlags
+{
+    enum Type
+    {
+        /** The camera is swinging back to behind the character */
+        Resetting       = 1 << 0,
+
+        /** The current reset was triggered by the idle timer rather than the player */
+        AutoReset       = 1 << 1,
+    };
+}
+
+/** Tuning shared by every camera in a batch. Built from a UExplorerCameraProfile. */
+struct FExplorerFollowCameraParams
+{
+    /** Exponent applied to the follow turn angle term */
+    float TurnAngleExponent;
+
+    /** Follow turn speed */
+    float TurnRate;
+
+    /** Speed used for manual resets */
+    float ResetSpeed;
+
+    /** Speed used for automatic (idle) resets */
+    float AutoResetSpeed;
+
+    /** A reset finishes once the camera is within this many degrees of its target */
+    float ResetToleranceDegrees;
+
+    /** Added to the mesh yaw to get the reset target. The character mesh is rotated -90 degrees from the capsule. */
+    float MeshYawOffset;
+
+    /**
+     * Optional: TurnAngleExponent applied to TurnResponseTableSize + 1 evenly spaced inputs from 0 to 1. When set,
+     * the turn angle term is looked up (with linear interpolation) instead of calling pow. Not owned.
+     */
+    const float* TurnResponseTable;
+    int TurnResponseTableSize;
+
+    FExplorerFollowCameraParams()
+        : TurnAngleExponent(.5f)
+        , TurnRate(.6f)
+        , ResetSpeed(2.f)
+        , AutoResetSpeed(.15f)
+        , ResetToleranceDegrees(1.f)
+        , MeshYawOffset(90.f)
+        , TurnResponseTable(0)
+        , TurnResponseTableSize(0)
+    {
+    }
+};
+
+/**
+ Structure-of-arrays view over a set of follow cameras. The solver does not own any of this memory.
+ Input arrays are read only, Flags is read and updated in place and YawInput is written.
+ */
+struct FExplorerFollowCameraBatch
+{
+    /** Number of cameras in the batch */
+    int Num;
+
+    /** Controller yaw for each camera */
+    const float* ControlYaw;
+
+    /** World yaw of each character's mesh */
+    const float* MeshYaw;
+
+    /** "MoveForward" axis value for each camera */
+    const float* ForwardAxis;
+
+    /** "MoveRight" axis value for each camera */
+    const float* RightAxis;
+
+    /** EExplorerFollowCameraFlags for each camera */
+    unsigned int* Flags;
+
+    /** Output: yaw input to add to each camera's controller this frame */
+    float* YawInput;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Scalar Path
+#pragma mark - Scalar Path
+
+/**
+ * The turn angle term raised to TurnAngleExponent, from the baked table when there is one.
+ * @param X	Turn angle term, from 0 to 1
+ */
+inline float EvaluateTurnResponse(const FExplorerFollowCameraParams& Params, float X)
+{
+    if (Params.TurnResponseTable == 0) return powf(X, Params.TurnAngleExponent);
+
+    const float position = X * Params.TurnResponseTableSize;
+    const int index = (int)position;
+    if (index >= Params.TurnResponseTableSize) return Params.TurnResponseTable[Params.TurnResponseTableSize];
+
+    const float a = Params.TurnResponseTable[index];
+    return a + (Params.TurnResponseTable[index + 1] - a) * (position - index);
+}
+
+/**
+ * Solves a single camera. This is the reference implementation; the SIMD path must agree with it.
+ * @param Params        Shared tuning
+ * @param DeltaSeconds  Frame time
+ * @param ControlYaw    Controller yaw
+ * @param MeshYaw       Mesh world yaw
+ * @param ForwardAxis   "MoveForward" axis value
+ * @param RightAxis     "MoveRight" axis value
+ * @param Flags         EExplorerFollowCameraFlags, updated in place
+ * @return The yaw input to add to the controller
+ */
+inline float SolveFollowCamera(const FExplorerFollowCameraParams& Params, float DeltaSeconds, float ControlYaw, float MeshYaw, float ForwardAxis, float RightAxis, unsigned int& Flags)
+{
+    if (Flags & EExplorerFollowCameraFlags::Resetting)
+    {
+        float delta = (MeshYaw + Params.MeshYawOffset) - ControlYaw;
+
+        // Prevent going "the long way around"
+        if (fabsf(delta) >= 180.f)
+        {
+            if (delta <= 0.f)
+                delta += 360.f;
+            else
+                delta -= 360.f;
+        }
+
+        if (fabsf(delta) <= Params.ResetToleranceDegrees)
+        {
+            Flags &= ~(EExplorerFollowCameraFlags::Resetting | EExplorerFollowCameraFlags::AutoReset);
+            return 0.f;
+        }
+
+        const float resetSpeed = (Flags & EExplorerFollowCameraFlags::AutoReset) ? Params.AutoResetSpeed : Params.ResetSpeed;
+        return delta * DeltaSeconds * resetSpeed;
+    }
+
+    float inputVectorLength = fabsf(ForwardAxis) + fabsf(RightAxis);
+    if (inputVectorLength > 1.f) inputVectorLength = 1.f;
+
+    if (inputVectorLength == 0.f) return 0.f;
+
+    // The combined input direction, relative to the camera, is atan2(right, forward). The world space version of
+    // this (build forward/right vectors from the control yaw, normalize, convert back to a rotator and take the
+    // normalized delta) reduces to the same angle, so the trig on the control yaw is not needed.
+    const float inputLength = sqrtf(ForwardAxis * ForwardAxis + RightAxis * RightAxis);
+    const float deltaYaw = atan2f(RightAxis, ForwardAxis) * (180.f / 3.14159265358979323846f);
+
+    // 1 = character is perpindicular to camera vector, 0 when parallel to camera vector.
+    // The forward term is intentionally not normalized; this matches the original Blueprint derived algorithm.
+    float dotProduct = 1.f - (ForwardAxis * ForwardAxis) / inputLength;
+    if (dotProduct < 0.f) dotProduct = 0.f;
+    if (dotProduct > 1.f) dotProduct = 1.f;
+    dotProduct = EvaluateTurnResponse(Params, dotProduct);
+
+    float turn = inputVectorLength * DeltaSeconds * dotProduct * Params.TurnRate;
+    if (turn < 0.f) turn = 0.f;
+    if (turn > 1.f) turn = 1.f;
+
+    return turn * deltaYaw;
+}
+
+/** Solves every camera in the batch one at a time */
+inline void SolveFollowCamerasScalar(const FExplorerFollowCameraParams& Params, float DeltaSeconds, FExplorerFollowCameraBatch& Batch, int First = 0)
+{
+    for (int i = First; i < Batch.Num; i++)
+    {
+        Batch.YawInput[i] = SolveFollowCamera(Params, DeltaSeconds, Batch.ControlYaw[i], Batch.MeshYaw[i], Batch.ForwardAxis[i], Batch.RightAxis[i], Batch.Flags[i]);
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// SSE2 Path
+#pragma mark - SSE2 Path
+
+#if EXPLORER_FOLLOW_SOLVER_SSE
+
+namespace ExplorerFollowCameraSolverSSE
+{
+    /** Absolute value, by clearing the sign bit */
+    inline __m128 Abs(__m128 X)
+    {
+        return _mm_and_ps(X, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+    }
+
+    /** Selects A where Mask is set, otherwise B */
+    inline __m128 Select(__m128 Mask, __m128 A, __m128 B)
+    {
+        return _mm_or_ps(_mm_and_ps(Mask, A), _mm_andnot_ps(Mask, B));
+    }
+
+    /** atan2 in radians. Max error is around 1e-5 radians. Undefined when both inputs are zero. */
+    inline __m128 Atan2(__m128 Y, __m128 X)
+    {
+        const __m128 absX = Abs(X);
+        const __m128 absY = Abs(Y);
+        const __m128 yIsLarger = _mm_cmpgt_ps(absY, absX);
+
+        const __m128 a = _mm_div_ps(_mm_min_ps(absX, absY), _mm_max_ps(absX, absY));
+        const __m128 s = _mm_mul_ps(a, a);
+
+        __m128 r = _mm_set1_ps(-0.01172120f);
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.05265332f));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.11643287f));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.19354346f));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(-0.33262347f));
+        r = _mm_add_ps(_mm_mul_ps(r, s), _mm_set1_ps(0.99997726f));
+        r = _mm_mul_ps(r, a);
+
+        r = Select(yIsLarger, _mm_sub_ps(_mm_set1_ps(1.57079637f), r), r);
+        r = Select(_mm_cmplt_ps(X, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(3.14159274f), r), r);
+
+        // Copy the sign of Y onto the result
+        const __m128 signY = _mm_and_ps(Y, _mm_castsi128_ps(_mm_set1_epi32(0x80000000)));
+        return _mm_or_ps(r, signY);
+    }
+
+    /** log2 for positive, normal inputs */
+    inline __m128 Log2(__m128 X)
+    {
+        const __m128i bits = _mm_castps_si128(X);
+        const __m128 exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+        const __m128 mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007fffff)), _mm_set1_epi32(0x3f800000)));
+
+        __m128 p = _mm_set1_ps(-3.4436006e-2f);
+        p = _mm_add_ps(_mm_mul_ps(p, mantissa), _mm_set1_ps(3.1821337e-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, mantissa), _mm_set1_ps(-1.2315303f));
+        p = _mm_add_ps(_mm_mul_ps(p, mantissa), _mm_set1_ps(2.5988452f));
+        p = _mm_add_ps(_mm_mul_ps(p, mantissa), _mm_set1_ps(-3.3241990f));
+        p = _mm_add_ps(_mm_mul_ps(p, mantissa), _mm_set1_ps(3.1157899f));
+        p = _mm_mul_ps(p, _mm_sub_ps(mantissa, _mm_set1_ps(1.f)));
+
+        return _mm_add_ps(p, exponent);
+    }
+
+    /** 2^X */
+    inline __m128 Exp2(__m128 X)
+    {
+        X = _mm_min_ps(X, _mm_set1_ps(127.f));
+        X = _mm_max_ps(X, _mm_set1_ps(-126.99999f));
+
+        // Floor, without relying on SSE4.1
+        __m128i whole = _mm_cvttps_epi32(X);
+        __m128 wholeF = _mm_cvtepi32_ps(whole);
+        const __m128 fixup = _mm_cmpgt_ps(wholeF, X);
+        whole = _mm_add_epi32(whole, _mm_castps_si128(fixup));
+        wholeF = _mm_cvtepi32_ps(whole);
+
+        const __m128 fraction = _mm_sub_ps(X, wholeF);
+        const __m128 wholePart = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(whole, _mm_set1_epi32(127)), 23));
+
+        __m128 p = _mm_set1_ps(1.8775767e-3f);
+        p = _mm_add_ps(_mm_mul_ps(p, fraction), _mm_set1_ps(8.9893397e-3f));
+        p = _mm_add_ps(_mm_mul_ps(p, fraction), _mm_set1_ps(5.5826318e-2f));
+        p = _mm_add_ps(_mm_mul_ps(p, fraction), _mm_set1_ps(2.4015361e-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, fraction), _mm_set1_ps(6.9315308e-1f));
+        p = _mm_add_ps(_mm_mul_ps(p, fraction), _mm_set1_ps(9.9999994e-1f));
+
+        return _mm_mul_ps(wholePart, p);
+    }
+
+    /** Base^Exponent for Base >= 0 */
+    inline __m128 Pow(__m128 Base, float Exponent)
+    {
+        const __m128 isZero = _mm_cmple_ps(Base, _mm_setzero_ps());
+        const __m128 safeBase = Select(isZero, _mm_set1_ps(1.f), Base);
+        const __m128 result = Exp2(_mm_mul_ps(Log2(safeBase), _mm_set1_ps(Exponent)));
+        return Select(isZero, _mm_set1_ps(Exponent == 0.f ? 1.f : 0.f), result);
+    }
+
+    /** The turn response for four inputs from 0 to 1. SSE2 has no gather, so table lookups are done one lane at a time. */
+    inline __m128 TurnResponse(const FExplorerFollowCameraParams& Params, __m128 X)
+    {
+        if (Params.TurnResponseTable == 0) return Pow(X, Params.TurnAngleExponent);
+
+        float lanes[4];
+        _mm_storeu_ps(lanes, X);
+        for (int lane = 0; lane < 4; lane++)
+        {
+            lanes[lane] = EvaluateTurnResponse(Params, lanes[lane]);
+        }
+        return _mm_loadu_ps(lanes);
+    }
+}
+
+/** Solves cameras four at a time. Any cameras left over are handled by the scalar path. */
+inline void SolveFollowCamerasSSE(const FExplorerFollowCameraParams& Params, float DeltaSeconds, FExplorerFollowCameraBatch& Batch)
+{
+    using namespace ExplorerFollowCameraSolverSSE;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.f);
+    const __m128 deltaSeconds = _mm_set1_ps(DeltaSeconds);
+    const __m128 halfTurn = _mm_set1_ps(180.f);
+    const __m128 fullTurn = _mm_set1_ps(360.f);
+    const __m128 meshYawOffset = _mm_set1_ps(Params.MeshYawOffset);
+    const __m128 tolerance = _mm_set1_ps(Params.ResetToleranceDegrees);
+    const __m128 resetSpeed = _mm_set1_ps(Params.ResetSpeed);
+    const __m128 autoResetSpeed = _mm_set1_ps(Params.AutoResetSpeed);
+    const __m128 turnRate = _mm_set1_ps(Params.TurnRate);
+    const __m128 radiansToDegrees = _mm_set1_ps(180.f / 3.14159265358979323846f);
+    const __m128i resettingBit = _mm_set1_epi32(EExplorerFollowCameraFlags::Resetting);
+    const __m128i autoResetBit = _mm_set1_epi32(EExplorerFollowCameraFlags::AutoReset);
+
+    const int simdNum = Batch.Num & ~3;
+    for (int i = 0; i < simdNum; i += 4)
+    {
+        const __m128 controlYaw = _mm_loadu_ps(Batch.ControlYaw + i);
+        const __m128 meshYaw = _mm_loadu_ps(Batch.MeshYaw + i);
+        const __m128 forwardAxis = _mm_loadu_ps(Batch.ForwardAxis + i);
+        const __m128 rightAxis = _mm_loadu_ps(Batch.RightAxis + i);
+        __m128i flags = _mm_loadu_si128((const __m128i*)(Batch.Flags + i));
+
+        const __m128 isResetting = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, resettingBit), resettingBit));
+        const __m128 isAutoReset = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(flags, autoResetBit), autoResetBit));
+
+        // Reset
+        __m128 resetDelta = _mm_sub_ps(_mm_add_ps(meshYaw, meshYawOffset), controlYaw);
+        const __m128 wrap = _mm_cmpge_ps(Abs(resetDelta), halfTurn);
+        const __m128 wrapAmount = Select(_mm_cmple_ps(resetDelta, zero), fullTurn, _mm_sub_ps(zero, fullTurn));
+        resetDelta = _mm_add_ps(resetDelta, _mm_and_ps(wrap, wrapAmount));
+
+        const __m128 resetDone = _mm_and_ps(isResetting, _mm_cmple_ps(Abs(resetDelta), tolerance));
+        const __m128 speed = Select(isAutoReset, autoResetSpeed, resetSpeed);
+        const __m128 resetInput = _mm_andnot_ps(resetDone, _mm_mul_ps(_mm_mul_ps(resetDelta, deltaSeconds), speed));
+
+        // Follow
+        const __m128 inputVectorLength = _mm_min_ps(_mm_add_ps(Abs(forwardAxis), Abs(rightAxis)), one);
+        const __m128 hasInput = _mm_cmpneq_ps(inputVectorLength, zero);
+
+        const __m128 forwardSquared = _mm_mul_ps(forwardAxis, forwardAxis);
+        const __m128 inputLength = _mm_sqrt_ps(_mm_add_ps(forwardSquared, _mm_mul_ps(rightAxis, rightAxis)));
+        const __m128 safeInputLength = Select(hasInput, inputLength, one);
+        const __m128 dotProduct = TurnResponse(Params, _mm_min_ps(_mm_max_ps(_mm_sub_ps(one, _mm_div_ps(forwardSquared, safeInputLength)), zero), one));
+        const __m128 deltaYaw = _mm_mul_ps(Atan2(rightAxis, Select(hasInput, forwardAxis, one)), radiansToDegrees);
+
+        __m128 turn = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(inputVectorLength, deltaSeconds), dotProduct), turnRate);
+        turn = _mm_min_ps(_mm_max_ps(turn, zero), one);
+        const __m128 followInput = _mm_and_ps(hasInput, _mm_mul_ps(turn, deltaYaw));
+
+        _mm_storeu_ps(Batch.YawInput + i, Select(isResetting, resetInput, followInput));
+
+        const __m128i clearMask = _mm_and_si128(_mm_castps_si128(resetDone), _mm_or_si128(resettingBit, autoResetBit));
+        flags = _mm_andnot_si128(clearMask, flags);
+        _mm_storeu_si128((__m128i*)(Batch.Flags + i), flags);
+    }
+
+    SolveFollowCamerasScalar(Params, DeltaSeconds, Batch, simdNum);
+}
+
+#endif // EXPLORER_FOLLOW_SOLVER_SSE
+
+//////////////////////////////////////////////////////////////////////////
+// Entry Point
+#pragma mark - Entry Point
+
+/**
+ * Advances every camera in the batch by one frame, using the SIMD path where available.
+ * @param Params        Tuning shared by every camera in the batch
+ * @param DeltaSeconds  Frame time
+ * @param Batch         Camera state. Flags and YawInput are written.
+ */
+inline void SolveFollowCameras(const FExplorerFollowCameraParams& Params, float DeltaSeconds, FExplorerFollowCameraBatch& Batch)
+{
+#if EXPLORER_FOLLOW_SOLVER_SSE
+    SolveFollowCamerasSSE(Params, DeltaSeconds, Batch);
+#else
+    SolveFollowCamerasScalar(Params, DeltaSeconds, Batch);
+#endif
+}
@@ -1,14 +1,84 @@
 // Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
 #pragma once
 #include "GameFramework/GameMode.h"
+#include "Engine/StreamableManager.h"
 #include "ExplorerGameMode.generated.h"
 
+/**
+ Game mode for the Explorer character.
+
+ The player's pawn class is referenced softly and streamed in asynchronously when the game starts, so the character
+ Blueprint and everything it pulls in (mesh, skeleton, animations) stay out of the blocking map load. Players that
+ join before it has loaded wait as spectators and are spawned as soon as it arrives.
+
+ The time from the start of the load (process start, or the start of map travel) to the first frame the local player
+ controls a pawn is written to the log, broken down by phase.
+
+ Explorer characters are pooled. PawnPoolSize of them are spawned, dormant, when play starts (or when the pawn class
+ arrives), players are handed one from the pool instead of a newly constructed character, and characters that leave
+ the game or respawn go back into the pool with their camera state reset. Spawn times and garbage collections are
+ counted, and written to the log with Explorer.Pool.Dump.
+ */
 UCLASS(minimalapi)
 class AExplorerGameMode : public AGameMode
 {
 	GENERATED_UCLASS_BODY()
 
-};
+    /** The player's pawn class, loaded asynchronously. Falls back to AExplorerCharacter if it cannot be loaded. */
+    UPROPERTY(EditAnywhere, config, Category=Classes)
+    TAssetSubclassOf<APawn> PlayerPawnClass;
+
+    /** Characters spawned into the pool ahead of time, and the most the pool keeps. Zero turns pooling off. */
+    UPROPERTY(EditAnywhere, config, Category=PawnPool)
+    int32 PawnPoolSize;
+
+    /** Whether PlayerPawnClass has finished loading (or failed to) and players can be spawned */
+    bool IsPawnClassLoaded() const { return PawnClassLoaded; }
+
+    /**
+     * Takes a pawn away from its controller and puts it back in the pool, or destroys it if it cannot be pooled or
+     * the pool is full.
+     */
+    void ReleasePawn(class APawn* Pawn);
+
+    /** Releases the player's pawn and restarts the player with one from the pool */
+    void RespawnPlayer(class AController* Player);
 
+    virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+    virtual void StartPlay() override;
+    virtual void RestartPlayer(class AController* NewPlayer) override;
+    virtual class APawn* SpawnDefaultPawnFor(class AController* NewPlayer, class AActor* StartSpot) override;
+    virtual void Tick(float DeltaSeconds) override;
 
+protected:
+    /** Called once PlayerPawnClass is in memory. Spawns the players that were waiting for it. */
+    virtual void OnPawnClassLoaded();
 
+    /** Logs the startup timings once the local player controls a pawn */
+    void ReportStartupTime();
+
+    /** Spawns dormant characters until the pool holds PawnPoolSize */
+    void PrewarmPawnPool();
+
+    /** Dormant characters ready to be handed out, most recently pooled last */
+    UPROPERTY(Transient)
+    TArray<class AExplorerCharacter*> PooledPawns;
+
+    /** Loads PlayerPawnClass. Owned by the game mode, since it is a GC object and must not outlive the engine. */
+    FStreamableManager Streamable;
+
+    /** Whether StartPlay has run, so the pool can be filled */
+    bool StartedPlay;
+
+    bool PawnClassLoaded;
+
+    /** Players whose spawn is waiting for the pawn class */
+    UPROPERTY(Transient)
+    TArray<class AController*> PendingRestarts;
+
+    /** FPlatformTime::Seconds() at each startup phase, zero until reached */
+    double InitGameSeconds;
+    double PawnClassLoadedSeconds;
+    double PlayerSpawnedSeconds;
+    bool ReportedStartupTime;
+};
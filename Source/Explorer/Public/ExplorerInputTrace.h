@@ -0,0 +1,224 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+/**
+ Binary input traces for AExplorerCharacter.
+
+ A trace captures everything the character's input bindings received, one record per frame, so that a play session
+ can be replayed headlessly as a regression or benchmark run.
+
+ File layout (little endian, no padding):
+
+     Header
+         uint32  Magic               'EXTR'
+         uint16  Version
+         uint16  HeaderSize          Size of the header in bytes, frames start at this offset
+         int64   StartTicks          FDateTime ticks when recording started
+         float   Location[3]         Actor location at the start of the recording
+         float   Rotation[3]         Actor rotation (pitch, yaw, roll)
+         float   ControlRotation[3]  Controller rotation (pitch, yaw, roll)
+         float   CameraZoom          CameraZoomCurrent
+         uint8   CameraMode          ECharacterCameraMode::Type
+
+     Frame (repeated until end of file)
+         float   DeltaSeconds        Frame time. A frame's timestamp is the sum of all previous DeltaSeconds.
+         uint8   AxisMask            One bit per EExplorerInputTraceAxis with a non-zero value this frame
+         uint8   ActionMask          One bit per EExplorerInputTraceAction that fired this frame
+         float   AxisValues[]        One value per bit set in AxisMask, in axis order
+
+ An idle frame costs six bytes. Recording is append only and there is no footer, so a trace cut short by a crash
+ is still readable up to the last complete frame.
+ */
+
+//////////////////////////////////////////////////////////////////////////
+// Trace Channels
+#pragma mark Trace Channels
+
+/** Axis bindings captured in a trace */
+namespace EExplorerInputTraceAxis
+{
+    enum Type
+    {
+        MoveForward,
+        MoveRight,
+        Turn,
+        TurnRate,
+        LookUp,
+        LookUpRate,
+
+        Max,
+    };
+}
+
+/** Action bindings captured in a trace */
+namespace EExplorerInputTraceAction
+{
+    enum Type
+    {
+        Jump,
+        ResetCamera,
+        ToggleCameraMode,
+        ZoomIn,
+        ZoomOut,
+        Touch,
+
+        Max,
+    };
+}
+
+/** Everything the input bindings received during one frame */
+struct FExplorerInputTraceFrame
+{
+    float DeltaSeconds;
+    float Axes[EExplorerInputTraceAxis::Max];
+    uint8 ActionMask;
+
+    FExplorerInputTraceFrame()
+    {
+        Reset();
+    }
+
+    void Reset()
+    {
+        DeltaSeconds = 0.f;
+        FMemory::Memzero(Axes, sizeof(Axes));
+        ActionMask = 0;
+    }
+
+    bool HasAction(EExplorerInputTraceAction::Type Action) const
+    {
+        return (ActionMask & (1 << Action)) != 0;
+    }
+};
+
+/** Character state captured when a recording starts, restored before a replay */
+struct FExplorerInputTraceHeader
+{
+    int64 StartTicks;
+    FVector Location;
+    FRotator Rotation;
+    FRotator ControlRotation;
+    float CameraZoom;
+    uint8 CameraMode;
+
+    FExplorerInputTraceHeader()
+        : StartTicks(0)
+        , Location(FVector::ZeroVector)
+        , Rotation(FRotator::ZeroRotator)
+        , ControlRotation(FRotator::ZeroRotator)
+        , CameraZoom(0.f)
+        , CameraMode(0)
+    {
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Recording
+#pragma mark - Recording
+
+/**
+ Writes an input trace. Input handlers report values as they arrive and EndFrame() commits them as one record.
+ Records are buffered in memory and written out in large blocks.
+ */
+class FExplorerInputTraceWriter
+{
+public:
+    ~FExplorerInputTraceWriter();
+
+    /**
+     * Creates the trace file and writes the header.
+     * @param Filename  Trace file to create
+     * @param Header    Starting state of the character
+     * @return The writer, or an invalid pointer if the file could not be created
+     */
+    static TSharedPtr<FExplorerInputTraceWriter> Create(const FString& Filename, const FExplorerInputTraceHeader& Header);
+
+    /** Records an axis value for the current frame */
+    void RecordAxis(EExplorerInputTraceAxis::Type Axis, float Value)
+    {
+        CurrentFrame.Axes[Axis] = Value;
+    }
+
+    /** Records an action for the current frame */
+    void RecordAction(EExplorerInputTraceAction::Type Action)
+    {
+        CurrentFrame.ActionMask |= (1 << Action);
+    }
+
+    /** Commits the current frame and starts a new one */
+    void EndFrame(float DeltaSeconds);
+
+    /** Flushes any buffered frames and closes the file */
+    void Close();
+
+    const FString& GetFilename() const { return Filename; }
+    int32 GetNumFrames() const { return NumFrames; }
+
+private:
+    FExplorerInputTraceWriter(const FString& InFilename, FArchive* InArchive);
+
+    void Flush();
+
+    FString Filename;
+    FArchive* Archive;
+    TArray<uint8> Buffer;
+    FExplorerInputTraceFrame CurrentFrame;
+    int32 NumFrames;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// Replay
+#pragma mark - Replay
+
+/**
+ Reads an input trace from a memory mapped file, one frame at a time. Only the pages being read are resident, so
+ multi-hour traces can be replayed without loading them up front.
+ */
+class FExplorerInputTraceReader
+{
+public:
+    ~FExplorerInputTraceReader();
+
+    /**
+     * Maps a trace file and validates its header.
+     * @param Filename  Trace file to open
+     * @return The reader, or an invalid pointer if the file is missing or is not a trace
+     */
+    static TSharedPtr<FExplorerInputTraceReader> Open(const FString& Filename);
+
+    const FExplorerInputTraceHeader& GetHeader() const { return Header; }
+    const FString& GetFilename() const { return Filename; }
+
+    /**
+     * Reads the next frame.
+     * @param OutFrame  Receives the frame
+     * @return false once the end of the trace is reached
+     */
+    bool ReadFrame(FExplorerInputTraceFrame& OutFrame);
+
+    /** Returns the next frame without consuming it */
+    bool PeekFrame(FExplorerInputTraceFrame& OutFrame) const;
+
+    int32 GetNumFramesRead() const { return NumFramesRead; }
+
+private:
+    FExplorerInputTraceReader(const FString& InFilename);
+
+    bool Map();
+    void Unmap();
+    int64 DecodeFrame(int64 Offset, FExplorerInputTraceFrame& OutFrame) const;
+
+    FString Filename;
+    const uint8* Data;
+    int64 Size;
+    int64 Offset;
+    int32 NumFramesRead;
+    FExplorerInputTraceHeader Header;
+
+    /** Platform handles for the mapping */
+    void* FileHandle;
+    void* MappingHandle;
+
+    /** Used when the platform has no memory mapping support */
+    TArray<uint8> FallbackData;
+};
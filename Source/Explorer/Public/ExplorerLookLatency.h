@@ -0,0 +1,56 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+/**
+ Look input latency measurement for AExplorerCharacter.
+
+ Each frame with look input is timestamped when the input reaches the character's handlers, together with the
+ control rotation it produced. When a view is computed, the newest recorded control rotation the view actually shows
+ marks that input (and any older input) as consumed, and the time and number of frames since the input are recorded.
+ Without the late camera update the spring arm picks the rotation up on its next component tick, so the difference
+ between the two paths shows up directly in these numbers:
+
+     Explorer.Latency.Dump      Explorer.Latency.Reset
+ */
+class FExplorerLookLatency
+{
+public:
+    FExplorerLookLatency();
+
+    /** Called by the look input handlers. The first look input of a frame starts the measurement. */
+    void NoteLookInput()
+    {
+        if (PendingInputSeconds == 0.0) PendingInputSeconds = FPlatformTime::Seconds();
+    }
+
+    /**
+     * Called when the view is computed.
+     * @param ControlRotation	The control rotation, including this frame's input
+     * @param ViewRotation		The rotation handed to the view
+     */
+    void NoteView(const FRotator& ControlRotation, const FRotator& ViewRotation);
+
+    /** Writes the latency measured so far, across all characters, to the log */
+    static void Dump();
+
+    /** Clears the measurements, e.g. after switching the late camera update on or off */
+    static void Reset();
+
+private:
+    /** Input that has been applied to the control rotation but not seen in a view yet */
+    struct FSample
+    {
+        double InputSeconds;
+        uint64 InputFrame;
+        FRotator ControlRotation;
+    };
+
+    /** Samples older than this many frames are dropped unmeasured (the view never caught up, e.g. with rotation lag) */
+    static const int32 MaxSamples = 8;
+
+    FSample Samples[MaxSamples];
+    int32 NumSamples;
+
+    /** When this frame's first look input arrived, or zero */
+    double PendingInputSeconds;
+};
@@ -0,0 +1,24 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+#include "GameFramework/PlayerController.h"
+#include "ExplorerPlayerController.generated.h"
+
+/**
+ Player controller for the Explorer character. It processes input through UExplorerPlayerInput, so that rate axes are
+ integrated from timestamped events, and hands its character back to AExplorerGameMode's pawn pool when it leaves.
+ */
+UCLASS()
+class AExplorerPlayerController : public APlayerController
+{
+    GENERATED_UCLASS_BODY()
+
+    /** Creates the UExplorerPlayerInput before the base class would create a plain UPlayerInput */
+    virtual void InitInputSystem() override;
+
+    /** Gives the character back to the pawn pool instead of destroying it */
+    virtual void PawnLeavingGame() override;
+
+    /** Swaps the player's character for one from the pawn pool. Only where the game mode runs (standalone, listen server). */
+    UFUNCTION(exec)
+    void Respawn();
+};
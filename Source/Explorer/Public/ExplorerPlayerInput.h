@@ -0,0 +1,132 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+#include "GameFramework/PlayerInput.h"
+#include "ExplorerPlayerInput.generated.h"
+
+/**
+ Player input that integrates rate axes (gamepad stick turning, arrow key turning) from the individual input events
+ rather than from one value per frame.
+
+ The stock path averages a rate axis' samples over the frame and the character multiplies the average by the frame
+ time, so a stick that moved mid-frame is applied as if it had been there all frame, and the error grows as the frame
+ rate drops. Here every event on a key mapped to an integrated axis is timestamped as it arrives. When a frame's
+ events arrived at distinct times within the frame, each value is held for exactly as long as it was current and the
+ newest one up to the moment the character consumes the axis. Events that arrive together in one batch carry no
+ timing within the frame, so for those frames (and frames with no events) the character falls back to the frame
+ value times the frame time, which applies a step on the frame it arrives rather than one frame later.
+
+ Limitation: in this engine version that fallback is what almost every frame gets. Events are stamped with
+ FPlatformTime::Seconds() when InputKey / InputAxis runs, because neither carries a device or OS timestamp. Gamepads
+ are polled once per frame and OS messages are processed in one deferred batch at the start of the frame, so a frame's
+ events land well within MinEventSpreadSeconds of each other. Real sub-frame integration needs timestamps from the
+ device or OS, or a sampling thread, none of which UPlayerInput sees here. Until then the integrating branch only
+ runs for input that genuinely arrives spread out, e.g. from a platform layer that dispatches events as they come in.
+
+ Only the axes in IntegratedAxes are integrated, and only for characters driven by an AExplorerPlayerController.
+ Input trace replays and scripted controllers use the frame time as before.
+ */
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerAxisIntegrator
+#pragma mark FExplorerAxisIntegrator
+
+/** Integrates one rate axis from the held values of the keys mapped to it */
+struct FExplorerAxisIntegrator
+{
+    /** Keys mapped to one axis */
+    static const int32 MaxKeys = 8;
+
+    /** Events closer together than this arrived in one batch, which says nothing about when within the frame they happened */
+    static const double MinEventSpreadSeconds;
+
+    FName AxisName;
+
+    FExplorerAxisIntegrator();
+
+    /** Clears the key mappings and any held values */
+    void Reset(FName InAxisName);
+
+    /** Adds a key to the axis. Keys past MaxKeys are ignored. */
+    void AddKey(FKey Key, float Scale);
+
+    /**
+     * Updates a key's value, integrating the axis' previous value since the previous event this frame.
+     * @return false if the key is not mapped to this axis
+     */
+    bool SetKeyValue(FKey Key, float Value, double Seconds);
+
+    /**
+     * Returns the integral over the frame ending now, when this frame's events carry timing within the frame.
+     * @param FrameValue		The axis value the input bindings saw this frame. When that is zero and no event arrived
+     *							since the last call, held values are dropped in case a release was missed.
+     * @param DeltaSeconds		The frame time
+     * @param Seconds			Now
+     * @param OutValueSeconds	Axis value times seconds
+     * @return false if there was nothing to integrate, and FrameValue * DeltaSeconds is the better answer
+     */
+    bool Consume(float FrameValue, float DeltaSeconds, double Seconds, float& OutValueSeconds);
+
+private:
+
+    FKey Keys[MaxKeys];
+    float Scales[MaxKeys];
+    float Values[MaxKeys];
+    int32 NumKeys;
+
+    /** Sum of the keys' scaled values */
+    float HeldValue;
+
+    /** HeldValue before the first event since the last Consume */
+    float ValueBeforeEvents;
+
+    /** When the first and newest events since the last Consume arrived */
+    double FirstEventSeconds;
+    double LastEventSeconds;
+
+    /** Integral between the events since the last Consume */
+    double Accumulated;
+
+    /** Whether any event arrived since the last Consume */
+    bool bSampled;
+};
+
+//////////////////////////////////////////////////////////////////////////
+// UExplorerPlayerInput
+#pragma mark - UExplorerPlayerInput
+
+UCLASS(config=Input, transient)
+class UExplorerPlayerInput : public UPlayerInput
+{
+    GENERATED_UCLASS_BODY()
+
+    /** Rate axes integrated from timestamped events */
+    UPROPERTY(config)
+    TArray<FName> IntegratedAxes;
+
+    /**
+     * Returns the integral of a rate axis over the frame.
+     * @param AxisName			The axis
+     * @param FrameValue		The axis value the input bindings saw this frame
+     * @param DeltaSeconds		The frame time
+     * @param OutValueSeconds	Axis value times seconds
+     * @return false if the axis is not integrated here, or this frame's events carry no timing within the frame
+     */
+    bool ConsumeIntegratedAxis(FName AxisName, float FrameValue, float DeltaSeconds, float& OutValueSeconds);
+
+    // UPlayerInput
+    virtual bool InputKey(FKey Key, enum EInputEvent Event, float AmountDepressed, bool bGamepad) override;
+    virtual bool InputAxis(FKey Key, float Delta, float DeltaTime, int32 NumSamples, bool bGamepad) override;
+
+protected:
+    /** Passes a key's new value to the integrators it is mapped to */
+    void SetIntegratedKeyValue(FKey Key, float Value);
+
+    /** Rebuilds the integrators' key lists when the axis mappings have changed */
+    void RefreshIntegrators();
+
+    /** One per IntegratedAxes entry */
+    TArray<FExplorerAxisIntegrator> Integrators;
+
+    /** AxisMappings.Num() when the integrators were built. The mappings are only ever rebuilt as a whole. */
+    int32 IntegratedMappingCount;
+};
@@ -0,0 +1,88 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+#include "Tickable.h"
+
+/**
+ Significance based throttling for large numbers of AExplorerCharacters.
+
+ A few times a second every character is scored against the local player's view (distance, and whether its mesh was
+ rendered recently), ranked, and given a detail level from fixed budgets: the top Explorer.Significance.FullBudget
+ characters get full detail, the next Explorer.Significance.ReducedBudget get reduced detail and everything else gets
+ minimal detail. Since the budgets are counts rather than distances, the cost stays roughly flat as the crowd grows.
+
+ Detail levels scale the character's tick rate, animation update rate, movement simulation iterations and shadow
+ casting. The local player's own character is always at full detail, and nothing is throttled without a local view
+ (dedicated servers).
+ */
+
+class AExplorerCharacter;
+
+namespace EExplorerSignificance
+{
+    enum Type
+    {
+        Full,
+        Reduced,
+        Minimal,
+
+        Max
+    };
+}
+
+class FExplorerSignificance : public FTickableGameObject
+{
+public:
+    static FExplorerSignificance& Get();
+
+    /** Adds a character to the ranking. Characters drop out on their own once destroyed. */
+    void Register(AExplorerCharacter* Character);
+
+    /** Takes a character out of the ranking, back at full detail, e.g. when it goes into the pawn pool */
+    void Unregister(AExplorerCharacter* Character);
+
+    /** Writes the number of characters at each detail level to the log */
+    void Dump() const;
+
+    // FTickableGameObject
+    virtual void Tick(float DeltaTime) override;
+    virtual bool IsTickable() const override { return Entries.Num() > 0; }
+    virtual TStatId GetStatId() const;
+
+private:
+    FExplorerSignificance();
+
+    struct FEntry
+    {
+        TWeakObjectPtr<AExplorerCharacter> Character;
+
+        EExplorerSignificance::Type Level;
+
+        /** Movement setting the character had before it was first throttled, restored at full detail */
+        int32 DefaultMaxSimulationIterations;
+    };
+
+    /** An entry's place in the ranking */
+    struct FRank
+    {
+        int32 Index;
+
+        /** Higher is more significant */
+        float Score;
+
+        bool operator<(const FRank& Other) const { return Score > Other.Score; }
+    };
+
+    /** Scores, ranks and re-levels every character */
+    void UpdateSignificance();
+
+    /** Changes a character's detail level */
+    void ApplyLevel(FEntry& Entry, EExplorerSignificance::Type Level);
+
+    TArray<FEntry> Entries;
+
+    /** Entries, most significant first. Kept around so ranking does not allocate. */
+    TArray<FRank> Ranking;
+
+    /** Time until the next update */
+    float SecondsUntilUpdate;
+};
@@ -0,0 +1,181 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+#include "ExplorerAllocations.h"
+
+/**
+ Performance instrumentation for the Explorer module.
+
+ "stat Explorer" shows cycle counters for the character's hot paths, and how many characters are in the follow
+ camera, resetting, or in first person. The same scopes can also be captured to a CSV file, one row per frame, so
+ that two builds can be diffed:
+
+     Explorer.Csv.Start [file]      Explorer.Csv.Stop
+
+ or from the command line, which works headless (-nullrhi) and pairs with an input trace replay:
+
+     -ExplorerCsv=<file> [-ExplorerCsvFrames=<count>]
+
+ When a capture stops, the average cost per call of the budgeted scopes is checked against the Explorer.Budget.*
+ console variables and any overrun is logged as an error. Overruns, like the other runtime checks, count as failed
+ checks, and a headless replay or stress run that had any exits with a non-zero exit code so a build can gate on it.
+
+ Instrument a scope with EXPLORER_SCOPE_CYCLE_COUNTER(Name), where STAT_ExplorerName and EExplorerCsvStat::Name
+ both exist. Outside a capture the CSV side costs one branch per scope. The same scopes count heap allocations, see
+ ExplorerAllocations.h.
+ */
+
+DECLARE_STATS_GROUP(TEXT("Explorer"), STATGROUP_Explorer, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Character Tick"), STAT_ExplorerTick, STATGROUP_Explorer, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Controller Tick"), STAT_ExplorerTickController, STATGROUP_Explorer, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Input Handlers"), STAT_ExplorerInput, STATGROUP_Explorer, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update For Camera Mode"), STAT_ExplorerUpdateForCameraMode, STATGROUP_Explorer, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Camera Rig Blend"), STAT_ExplorerCameraRigBlend, STATGROUP_Explorer, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Follow Camera"), STAT_ExplorerFollowCamera, STATGROUP_Explorer, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Camera Collision"), STAT_ExplorerCameraCollision, STATGROUP_Explorer, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Significance"), STAT_ExplorerSignificance, STATGROUP_Explorer, );
+
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Follow Camera Characters"), STAT_ExplorerFollowCharacters, STATGROUP_Explorer, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Resetting Characters"), STAT_ExplorerResettingCharacters, STATGROUP_Explorer, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("First Person Characters"), STAT_ExplorerFirstPersonCharacters, STATGROUP_Explorer, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Blending Characters"), STAT_ExplorerBlendingCharacters, STATGROUP_Explorer, );
+
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Look Input Latency (ms)"), STAT_ExplorerLookLatency, STATGROUP_Explorer, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Visible Textures Short Of Mips"), STAT_ExplorerStreamingShortTextures, STATGROUP_Explorer, );
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Allocations"), STAT_ExplorerAllocations, STATGROUP_Explorer, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Allocated Bytes"), STAT_ExplorerAllocatedBytes, STATGROUP_Explorer, );
+
+/** Scopes captured to CSV. Each has a matching STAT_Explorer cycle stat. */
+namespace EExplorerCsvStat
+{
+    enum Type
+    {
+        Tick,
+        TickController,
+        Input,
+        UpdateForCameraMode,
+        CameraRigBlend,
+        FollowCamera,
+        CameraCollision,
+        Significance,
+
+        Max
+    };
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FExplorerStats
+#pragma mark FExplorerStats
+
+class FExplorerStats
+{
+public:
+    /** What a character contributes to the character counts */
+    enum ECharacterCount
+    {
+        FollowCount         = 1 << 0,
+        ResettingCount      = 1 << 1,
+        FirstPersonCount    = 1 << 2,
+        BlendingCount       = 1 << 3,
+    };
+
+    /**
+     * Moves a character between the character counts.
+     * @param OldCounts	ECharacterCount flags the character was counted under
+     * @param NewCounts	ECharacterCount flags it should be counted under now
+     */
+    static void UpdateCharacterCounts(uint8 OldCounts, uint8 NewCounts);
+
+    /** Makes sure the per-frame stats and CSV collector is running. Called when a character begins play. */
+    static void Initialize();
+
+    /** The name a scope is captured under */
+    static const TCHAR* GetCsvStatName(EExplorerCsvStat::Type Stat);
+
+    /** Whether a CSV capture is running */
+    static bool IsCapturingCsv() { return bCapturingCsv; }
+
+    /** Adds a scope's time to the current CSV frame */
+    static void AddCsvCycles(EExplorerCsvStat::Type Stat, uint32 Cycles)
+    {
+        CsvFrameCycles[Stat] += Cycles;
+        CsvFrameCalls[Stat]++;
+    }
+
+    /**
+     * Starts capturing per-frame timings to a CSV file.
+     * @param Filename	The file to write. Defaults to a timestamped file in Saved/Profiling.
+     * @param NumFrames	Stop automatically after this many frames. Zero captures until stopped.
+     */
+    static bool StartCsvCapture(const FString& Filename, int32 NumFrames = 0);
+
+    /** Stops the CSV capture and closes the file, then checks the captured timings against the budgets */
+    static void StopCsvCapture();
+
+    /** Whether any capture so far has gone over budget */
+    static bool HasExceededBudget() { return bExceededBudget; }
+
+    /** Records a failed runtime check, such as a budget overrun or a camera reset that misbehaves. Log the details first. */
+    static void NoteFailedCheck() { NumFailedChecks++; }
+
+    /** How many runtime checks have failed so far */
+    static int32 GetNumFailedChecks() { return NumFailedChecks; }
+
+    /**
+     * Ends a headless replay or stress run. Stops any CSV capture so its budgets are checked and any allocation tracking
+     * so steady state allocations count as a failed check, then exits. If any check failed, GIsCriticalError is set and
+     * the exit is forced, so the process returns a non-zero exit code.
+     * @param RunName	What ran, for the log
+     */
+    static void ExitHeadlessRun(const TCHAR* RunName);
+
+    /** Writes the current frame's CSV row. Called once per frame. */
+    static void EndCsvFrame(float DeltaSeconds);
+
+    static int32 NumFollowCharacters;
+    static int32 NumResettingCharacters;
+    static int32 NumFirstPersonCharacters;
+    static int32 NumBlendingCharacters;
+
+private:
+    /** Compares the capture's averages with the budgets */
+    static void CheckBudgets();
+
+    static bool bCapturingCsv;
+    static bool bExceededBudget;
+    static int32 NumFailedChecks;
+    static uint32 CsvFrameCycles[EExplorerCsvStat::Max];
+    static uint32 CsvFrameCalls[EExplorerCsvStat::Max];
+    static uint64 CsvTotalCycles[EExplorerCsvStat::Max];
+    static uint64 CsvTotalCalls[EExplorerCsvStat::Max];
+};
+
+/** Times a scope for the CSV capture. Use through EXPLORER_SCOPE_CYCLE_COUNTER. */
+class FExplorerCsvScope
+{
+public:
+    explicit FExplorerCsvScope(EExplorerCsvStat::Type InStat)
+        : Stat(InStat)
+        , StartCycles(FExplorerStats::IsCapturingCsv() ? FPlatformTime::Cycles() : 0)
+    {
+    }
+
+    ~FExplorerCsvScope()
+    {
+        if (StartCycles != 0)
+        {
+            FExplorerStats::AddCsvCycles(Stat, FPlatformTime::Cycles() - StartCycles);
+        }
+    }
+
+private:
+    EExplorerCsvStat::Type Stat;
+    uint32 StartCycles;
+};
+
+#define EXPLORER_SCOPE_CYCLE_COUNTER(Name) \
+    SCOPE_CYCLE_COUNTER(STAT_Explorer##Name); \
+    FExplorerCsvScope ExplorerCsvScope_##Name(EExplorerCsvStat::Name); \
+    FExplorerAllocationScope ExplorerAllocationScope_##Name(EExplorerCsvStat::Name)
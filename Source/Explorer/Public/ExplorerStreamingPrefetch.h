@@ -0,0 +1,85 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+
+/**
+ Texture streaming prefetch for AExplorerCharacter's camera.
+
+ The texture streamer only knows where the camera is, so when the camera swings around the textures it turns towards
+ arrive late and pop in. The camera's motion is predictable, though: a follow camera reset heads for behind the mesh,
+ and a fast turn carries on for a moment. Each frame the view is extrapolated StreamingPrefetchSeconds ahead (and,
+ during a reset, to where the reset ends), and those viewpoints are handed to the streamer as extra view locations.
+
+ With Explorer.Streaming.Measure 1, every frame the view is computed it also records whether any texture on screen is
+ short of the mips this view wants, separately for frames with and without prediction. The streamer's own backlog is
+ no measure of that: it covers every view and texture in the world, and the predicted viewpoints add to it. So the
+ wanted mips are estimated here for the current view alone, from the streaming info of the primitives rendered last
+ frame, and compared with the mips resident. That walks the whole world every frame, so it is off by default and
+ compiles out of Shipping builds. Explorer.Streaming.Predict 0 switches prediction off to get the baseline:
+
+     Explorer.Streaming.Predict 0|1     Explorer.Streaming.Measure 0|1     Explorer.Streaming.Dump     Explorer.Streaming.Reset
+ */
+
+#define EXPLORER_STREAMING_MEASURE (!UE_BUILD_SHIPPING)
+
+class FExplorerStreamingPrefetch
+{
+public:
+    /** Where the camera is and where it is heading */
+    struct FView
+    {
+        /** Where the camera arm starts */
+        FVector Pivot;
+
+        /** The view being shown */
+        FVector Location;
+        FRotator Rotation;
+        float FOV;
+
+        /** Whether a follow camera reset is running, and the yaw it is heading for */
+        bool bResetting;
+        float ResetTargetYaw;
+
+        /** How far ahead to predict. Zero turns prediction off for this view. */
+        float HorizonSeconds;
+    };
+
+    FExplorerStreamingPrefetch();
+
+    /**
+     * Called when the view is computed. Registers the predicted viewpoints and records the streaming state.
+     * @param World			The world being viewed
+     * @param View			The view and its prediction inputs
+     * @param DeltaSeconds	Frame time
+     */
+    void NoteView(UWorld* World, const FView& View, float DeltaSeconds);
+
+#if EXPLORER_STREAMING_MEASURE
+    /** Writes the streaming results so far, across all characters, to the log */
+    static void Dump();
+
+    /** Clears the streaming results, e.g. after switching prediction on or off */
+    static void Reset();
+#endif
+
+private:
+    /** Registers a viewpoint at Yaw around the pivot, as far out as the current view */
+    static void AddPredictedView(const FView& View, float Yaw);
+
+#if EXPLORER_STREAMING_MEASURE
+    /** Counts the textures on the primitives rendered last frame that have fewer mips resident than View wants */
+    int32 CountVisibleTexturesShortOfMips(UWorld* World, const FView& View);
+
+    /** Scratch space for CountVisibleTexturesShortOfMips, kept so the count does not allocate every frame */
+    TArray<UPrimitiveComponent*> Components;
+    TArray<FStreamingTexturePrimitiveInfo> TextureInfos;
+
+    /** Textures found short of mips, as addresses so they sort without dereferencing. Duplicates are counted once. */
+    TArray<UPTRINT> ShortTextures;
+#endif
+
+    /** The view yaw last frame, for the turn rate */
+    float PreviousYaw;
+
+    /** Whether PreviousYaw has been set */
+    bool HasPreviousYaw;
+};
@@ -0,0 +1,60 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+#include "AIController.h"
+#include "ExplorerInputTrace.h"
+#include "ExplorerStressController.generated.h"
+
+/**
+ Drives an AExplorerCharacter with scripted input for AExplorerStressGameMode.
+
+ The script loops through phases that exercise every part of the controller: switching camera mode and zooming,
+ walking with the odd jump, turning and looking around, and standing still for longer than the character's
+ AutoResetDelaySeconds so that the follow camera resets itself. Input goes through the character's input handlers,
+ the same path an input trace replay takes, so the character cannot tell it apart from a player.
+ */
+
+namespace EExplorerStressPhase
+{
+    enum Type
+    {
+        CameraAndZoom,
+        Walk,
+        LookAround,
+        Idle,
+
+        Max
+    };
+}
+
+UCLASS()
+class AExplorerStressController : public AAIController
+{
+    GENERATED_UCLASS_BODY()
+
+    /** Seeds the script. Controllers with different seeds drift out of step with each other. */
+    void SetScriptSeed(int32 Seed);
+
+    virtual void Tick(float DeltaSeconds) override;
+
+protected:
+    /** Moves on to the next phase of the script */
+    void StartNextPhase();
+
+    /** Fills Frame with this frame's scripted input */
+    void BuildFrame(float DeltaSeconds);
+
+    FRandomStream Random;
+
+    /** Index into the script */
+    int32 ScriptStep;
+
+    EExplorerStressPhase::Type Phase;
+    float PhaseSeconds;
+    float PhaseDuration;
+
+    /** Time until the next zoom step in the CameraAndZoom phase */
+    float SecondsUntilZoom;
+
+    /** Reused every frame */
+    FExplorerInputTraceFrame Frame;
+};
@@ -0,0 +1,64 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+#pragma once
+#include "ExplorerGameMode.h"
+#include "ExplorerStressGameMode.generated.h"
+
+/**
+ Crowd stress test for AExplorerCharacter.
+
+ Spawns NumCharacters characters in a grid around the player start, each driven by an AExplorerStressController, and
+ after StressSeconds logs frame time percentiles, game thread time and memory. Select it from the command line:
+
+     MyMap?game=/Script/Explorer.ExplorerStressGameMode?StressCharacters=200?StressSeconds=60
+
+ Add ?StressExit to quit once the report has been written, for unattended runs. The process exits non-zero if any of
+ the Explorer runtime checks failed during the run.
+ */
+
+UCLASS(config=Game)
+class AExplorerStressGameMode : public AExplorerGameMode
+{
+    GENERATED_UCLASS_BODY()
+
+    /** How many characters to spawn. Overridden by the StressCharacters URL option. */
+    UPROPERTY(EditAnywhere, config, Category=Stress)
+    int32 NumCharacters;
+
+    /** How long to measure for, in seconds, not counting the warm up. Overridden by the StressSeconds URL option. */
+    UPROPERTY(EditAnywhere, config, Category=Stress)
+    float StressSeconds;
+
+    /** Frames in the first few seconds are not measured, while characters settle and assets finish loading */
+    UPROPERTY(EditAnywhere, config, Category=Stress)
+    float WarmUpSeconds;
+
+    /** Distance between characters in the spawn grid */
+    UPROPERTY(EditAnywhere, config, Category=Stress)
+    float SpawnSpacing;
+
+    /** The character to spawn. Defaults to the player pawn class if that is an AExplorerCharacter. */
+    UPROPERTY(EditAnywhere, Category=Stress)
+    TSubclassOf<class AExplorerCharacter> CharacterClass;
+
+    virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+    virtual void StartPlay() override;
+    virtual void Tick(float DeltaSeconds) override;
+
+protected:
+    virtual void OnPawnClassLoaded() override;
+
+    /** Spawns the characters and their controllers, once play has started and the pawn class has loaded */
+    void SpawnCrowd();
+
+    /** Logs the results */
+    void Report();
+
+    /** Frame and game thread times for every measured frame, in milliseconds. Reserved up front. */
+    TArray<float> FrameMilliseconds;
+    TArray<float> GameThreadMilliseconds;
+
+    float ElapsedSeconds;
+    bool CrowdSpawned;
+    bool IsFinished;
+    bool ExitWhenFinished;
+};
@@ -0,0 +1,282 @@
+// Copyright 1998-2014 Epic Games, Inc. All Rights Reserved.
+
+/**
+ Standalone check for ExplorerFollowCameraSolver.h. Needs no engine or editor, only a C++ compiler:
+
+     g++ -O2 -msse2 -I Source/Explorer/Public Tests/FollowCameraSolverTest.cpp -o FollowCameraSolverTest
+     ./FollowCameraSolverTest
+
+ Runs random camera states through the SSE path, the scalar path and a literal port of the original
+ AExplorerCharacter::Tick math, with and without the baked turn response table, and exits non-zero on any mismatch.
+ When the compiler doesn't target SSE2 the SSE comparisons are skipped.
+ */
+
+#include "ExplorerFollowCameraSolver.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////
+// Legacy Math
+#pragma mark Legacy Math
+
+namespace FollowCameraSolverTest
+{
+    const float Pi = 3.14159265358979323846f;
+
+    /** FRotator::NormalizeAxis */
+    float NormalizeAxis(float Angle)
+    {
+        Angle = fmodf(Angle, 360.f);
+        if (Angle < 0.f) Angle += 360.f;
+        if (Angle > 180.f) Angle -= 360.f;
+        return Angle;
+    }
+
+    /**
+     * The follow camera math as it was in AExplorerCharacter::Tick before it moved into the solver: forward and right
+     * vectors from the control yaw, normalize, back to a rotator and take the normalized delta.
+     */
+    float LegacySolve(const FExplorerFollowCameraParams& Params, float DeltaSeconds, float ControlYaw, float MeshYaw, float ForwardAxis, float RightAxis, unsigned int& Flags)
+    {
+        if (Flags & EExplorerFollowCameraFlags::Resetting)
+        {
+            float delta = (MeshYaw + 90.f) - ControlYaw;
+            if (fabsf(delta) >= 180.f)
+            {
+                if (delta <= 0.f)
+                    delta += 360.f;
+                else
+                    delta -= 360.f;
+            }
+
+            if (fabsf(delta) <= 1.f)
+            {
+                Flags &= ~(EExplorerFollowCameraFlags::Resetting | EExplorerFollowCameraFlags::AutoReset);
+                return 0.f;
+            }
+
+            const float resetSpeed = (Flags & EExplorerFollowCameraFlags::AutoReset) ? Params.AutoResetSpeed : Params.ResetSpeed;
+            return delta * DeltaSeconds * resetSpeed;
+        }
+
+        float inputVectorLength = fabsf(ForwardAxis) + fabsf(RightAxis);
+        if (inputVectorLength > 1.f) inputVectorLength = 1.f;
+        if (inputVectorLength == 0.f) return 0.f;
+
+        const float yaw = ControlYaw * Pi / 180.f;
+        const float forward[2] = { cosf(yaw), sinf(yaw) };
+        const float right[2] = { -sinf(yaw), cosf(yaw) };
+
+        const float forwardVector[2] = { forward[0] * ForwardAxis, forward[1] * ForwardAxis };
+        const float rightVector[2] = { right[0] * RightAxis, right[1] * RightAxis };
+
+        float combined[2] = { forwardVector[0] + rightVector[0], forwardVector[1] + rightVector[1] };
+        const float combinedLength = sqrtf(combined[0] * combined[0] + combined[1] * combined[1]);
+        combined[0] /= combinedLength;
+        combined[1] /= combinedLength;
+
+        float dotProduct = 1.f - fabsf(forwardVector[0] * combined[0] + forwardVector[1] * combined[1]);
+        dotProduct = powf(dotProduct, Params.TurnAngleExponent);
+
+        const float combinedYaw = atan2f(combined[1], combined[0]) * 180.f / Pi;
+        const float deltaYaw = NormalizeAxis(combinedYaw - ControlYaw);
+
+        float turn = inputVectorLength * DeltaSeconds * dotProduct * Params.TurnRate;
+        if (turn < 0.f) turn = 0.f;
+        if (turn > 1.f) turn = 1.f;
+        return turn * deltaYaw;
+    }
+
+    float RandomRange(float Min, float Max)
+    {
+        return Min + (Max - Min) * ((float)rand() / RAND_MAX);
+    }
+
+    /** Axis values from -1 to 1, with a share of exact zeros and full deflections like a keyboard produces */
+    float RandomAxis()
+    {
+        const int kind = rand() % 4;
+        if (kind == 0) return 0.f;
+        if (kind == 1) return (rand() % 2) ? 1.f : -1.f;
+        return RandomRange(-1.f, 1.f);
+    }
+
+    struct FCameras
+    {
+        std::vector<float> ControlYaw, MeshYaw, ForwardAxis, RightAxis, YawInput;
+        std::vector<unsigned int> Flags;
+
+        explicit FCameras(int Num)
+            : ControlYaw(Num), MeshYaw(Num), ForwardAxis(Num), RightAxis(Num), YawInput(Num), Flags(Num)
+        {
+            for (int i = 0; i < Num; i++)
+            {
+                ControlYaw[i] = RandomRange(0.f, 360.f);
+                MeshYaw[i] = RandomRange(-180.f, 180.f);
+                ForwardAxis[i] = RandomAxis();
+                RightAxis[i] = RandomAxis();
+
+                const int state = rand() % 4;
+                Flags[i] = (state == 0) ? EExplorerFollowCameraFlags::Resetting
+                    : (state == 1) ? (EExplorerFollowCameraFlags::Resetting | EExplorerFollowCameraFlags::AutoReset)
+                    : 0;
+            }
+        }
+
+        FExplorerFollowCameraBatch GetBatch()
+        {
+            FExplorerFollowCameraBatch batch;
+            batch.Num = (int)Flags.size();
+            batch.ControlYaw = &ControlYaw[0];
+            batch.MeshYaw = &MeshYaw[0];
+            batch.ForwardAxis = &ForwardAxis[0];
+            batch.RightAxis = &RightAxis[0];
+            batch.Flags = &Flags[0];
+            batch.YawInput = &YawInput[0];
+            return batch;
+        }
+    };
+
+    int NumFailures = 0;
+
+    /**
+     * Compares two solved copies of the same cameras.
+     * @param bEitherWayBehind  Input straight behind the camera turns +/-180 degrees depending on rounding in the legacy
+     *                          math, so for those cameras only the size of the yaw input is compared.
+     */
+    void Compare(const char* What, const FCameras& Expected, const FCameras& Actual, float Tolerance, bool bEitherWayBehind = false)
+    {
+        float maxError = 0.f;
+        int worst = 0;
+        int flagMismatches = 0;
+        for (size_t i = 0; i < Expected.YawInput.size(); i++)
+        {
+            const bool directlyBehind = Expected.RightAxis[i] == 0.f && Expected.ForwardAxis[i] < 0.f && !(Expected.Flags[i] & EExplorerFollowCameraFlags::Resetting);
+            const float error = (bEitherWayBehind && directlyBehind)
+                ? fabsf(fabsf(Expected.YawInput[i]) - fabsf(Actual.YawInput[i]))
+                : fabsf(Expected.YawInput[i] - Actual.YawInput[i]);
+            if (error > maxError)
+            {
+                maxError = error;
+                worst = (int)i;
+            }
+            if (Expected.Flags[i] != Actual.Flags[i]) flagMismatches++;
+        }
+
+        const bool passed = maxError <= Tolerance && flagMismatches == 0;
+        printf("%s %-40s max error %g (tolerance %g), %d flag mismatches\n", passed ? "PASS" : "FAIL", What, maxError, Tolerance, flagMismatches);
+        if (!passed)
+        {
+            printf("     worst: control yaw %g, mesh yaw %g, forward %g, right %g: expected %g, got %g\n",
+                Expected.ControlYaw[worst], Expected.MeshYaw[worst], Expected.ForwardAxis[worst], Expected.RightAxis[worst],
+                Expected.YawInput[worst], Actual.YawInput[worst]);
+            NumFailures++;
+        }
+    }
+
+    void Check(const char* What, bool bPassed)
+    {
+        printf("%s %s\n", bPassed ? "PASS" : "FAIL", What);
+        if (!bPassed) NumFailures++;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Tests
+#pragma mark - Tests
+
+int main()
+{
+    using namespace FollowCameraSolverTest;
+
+    srand(1);
+
+    // Matches UExplorerCameraProfile::TurnResponseTableSize and Bake()
+    const int tableSize = 128;
+    float table[tableSize + 1];
+
+    FExplorerFollowCameraParams params;
+    for (int i = 0; i <= tableSize; i++)
+    {
+        table[i] = powf((float)i / tableSize, params.TurnAngleExponent);
+    }
+
+    FExplorerFollowCameraParams tableParams = params;
+    tableParams.TurnResponseTable = table;
+    tableParams.TurnResponseTableSize = tableSize;
+
+    // Table lookup: exact on the samples, monotonic, and within the interpolation error of sqrt in between
+    bool exactOnSamples = true;
+    for (int i = 0; i <= tableSize; i++)
+    {
+        exactOnSamples &= EvaluateTurnResponse(tableParams, (float)i / tableSize) == table[i];
+    }
+    Check("turn response table is exact on samples", exactOnSamples);
+
+    bool monotonic = true;
+    float maxTableError = 0.f;
+    float previous = 0.f;
+    for (int i = 0; i <= 100000; i++)
+    {
+        const float x = i / 100000.f;
+        const float value = EvaluateTurnResponse(tableParams, x);
+        monotonic &= value >= previous;
+        previous = value;
+        maxTableError = fmaxf(maxTableError, fabsf(value - powf(x, params.TurnAngleExponent)));
+    }
+    Check("turn response table is monotonic", monotonic);
+
+    // Linear interpolation of sqrt is worst in the first interval, at a quarter of the way in: sqrt(1/N) / 4
+    const float tableTolerance = .25f * sqrtf(1.f / tableSize) + 1e-4f;
+    printf("     max table error %g (tolerance %g)\n", maxTableError, tableTolerance);
+    Check("turn response table matches pow", maxTableError <= tableTolerance);
+
+    const int numCameras = 100003; // Not a multiple of four, so the scalar tail runs too
+    const float deltaSeconds = 1.f / 60.f;
+    const FCameras cameras(numCameras);
+
+    // Legacy math vs scalar path. The legacy vector round trip loses precision for input just off straight behind
+    // the camera, so the tolerance is looser than the solver's own paths need.
+    FCameras legacy = cameras;
+    for (int i = 0; i < numCameras; i++)
+    {
+        legacy.YawInput[i] = LegacySolve(params, deltaSeconds, legacy.ControlYaw[i], legacy.MeshYaw[i], legacy.ForwardAxis[i], legacy.RightAxis[i], legacy.Flags[i]);
+    }
+
+    FCameras scalar = cameras;
+    FExplorerFollowCameraBatch scalarBatch = scalar.GetBatch();
+    SolveFollowCamerasScalar(params, deltaSeconds, scalarBatch);
+    Compare("scalar vs legacy", legacy, scalar, 1e-3f, true);
+
+    // The table only changes the turn term, which is scaled by DeltaSeconds * TurnRate * 180 at most
+    FCameras scalarTable = cameras;
+    FExplorerFollowCameraBatch scalarTableBatch = scalarTable.GetBatch();
+    SolveFollowCamerasScalar(tableParams, deltaSeconds, scalarTableBatch);
+    Compare("scalar (table) vs legacy", legacy, scalarTable, tableTolerance * deltaSeconds * params.TurnRate * 180.f + 1e-3f, true);
+
+#if EXPLORER_FOLLOW_SOLVER_SSE
+    FCameras sse = cameras;
+    FExplorerFollowCameraBatch sseBatch = sse.GetBatch();
+    SolveFollowCamerasSSE(params, deltaSeconds, sseBatch);
+    Compare("sse vs scalar", scalar, sse, 1e-3f);
+    Compare("sse vs legacy", legacy, sse, 1e-3f, true);
+
+    FCameras sseTable = cameras;
+    FExplorerFollowCameraBatch sseTableBatch = sseTable.GetBatch();
+    SolveFollowCamerasSSE(tableParams, deltaSeconds, sseTableBatch);
+    Compare("sse (table) vs scalar (table)", scalarTable, sseTable, 1e-3f);
+#else
+    printf("SKIP sse: EXPLORER_FOLLOW_SOLVER_SSE is 0 for this compiler\n");
+#endif
+
+    // The entry point should agree with whichever path it picked
+    FCameras entry = cameras;
+    FExplorerFollowCameraBatch entryBatch = entry.GetBatch();
+    SolveFollowCameras(tableParams, deltaSeconds, entryBatch);
+    Compare("SolveFollowCameras vs scalar (table)", scalarTable, entry, 1e-3f);
+
+    printf("%s: %d failure(s)\n", NumFailures ? "FAILED" : "PASSED", NumFailures);
+    return NumFailures ? 1 : 0;
+}